@@ -0,0 +1,290 @@
+/*------------------------------------------------------------------------------
+    * File:        Aot.cpp                                                     *
+    * Description: Ahead-of-time C++ code generator for expression trees with  *
+    *              the on-disk cache of shared objects.                        *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+#include "Aot.h"
+
+#if defined (AOT_SUPPORTED)
+    #include <dlfcn.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+/*
+ * Generated source does not depend on the calculator headers, so functions
+ * are defined here the same way as calcFunction does it.
+ */
+
+char const * const AOT_PREAMBLE =
+    "#include <complex>\n"
+    "\n"
+    "namespace calc {\n"
+    "\n"
+    "typedef std::complex<double> num;\n"
+    "\n"
+    "static const num PI = { 0x1.921fb54442d18p+1, 0 };\n"
+    "static const num ONE = 1;\n"
+    "static const num TWO = 2;\n"
+    "\n"
+    "static inline num arccos  (num x) { return std::acos(x);         }\n"
+    "static inline num arccosh (num x) { return std::acosh(x);        }\n"
+    "static inline num arccot  (num x) { return PI/TWO - std::atan(x); }\n"
+    "static inline num arccoth (num x) { return std::atanh(ONE / x);  }\n"
+    "static inline num arcsin  (num x) { return std::asin(x);         }\n"
+    "static inline num arcsinh (num x) { return std::asinh(x);        }\n"
+    "static inline num arctan  (num x) { return std::atan(x);         }\n"
+    "static inline num arctanh (num x) { return std::atanh(x);        }\n"
+    "static inline num cos     (num x) { return std::cos(x);          }\n"
+    "static inline num cosh    (num x) { return std::cosh(x);         }\n"
+    "static inline num cot     (num x) { return ONE / std::tan(x);    }\n"
+    "static inline num coth    (num x) { return ONE / std::tanh(x);   }\n"
+    "static inline num exp     (num x) { return std::exp(x);          }\n"
+    "static inline num lg      (num x) { return std::log10(x);        }\n"
+    "static inline num ln      (num x) { return std::log(x);          }\n"
+    "static inline num sin     (num x) { return std::sin(x);          }\n"
+    "static inline num sinh    (num x) { return std::sinh(x);         }\n"
+    "static inline num sqrt    (num x) { return std::sqrt(x);         }\n"
+    "static inline num tan     (num x) { return std::tan(x);          }\n"
+    "static inline num tanh    (num x) { return std::tanh(x);         }\n"
+    "static inline num pow     (num x, num y) { return std::pow(x, y); }\n"
+    "\n"
+    "} // namespace calc\n"
+    "\n";
+
+const size_t AOT_MAX_NODE_SIZE = 96;
+
+//------------------------------------------------------------------------------
+
+Aot::Aot (Tree<CalcNodeData>& tree) :
+    state_   (CALC_OK),
+    program_ (tree)
+{
+    /* nothing to build, Execute reports the error of the program */
+    if (program_.getErrCode()) return;
+
+    code_ = new char[AOT_MAX_NODE_SIZE * (CountNodes(tree.root_) + 1)] {};
+
+    char* str = code_;
+    if (Node2Code(tree.root_, program_, &str)) return;
+
+#if defined (AOT_SUPPORTED)
+    char basename[MAX_STR_LEN] = "";
+    sprintf(basename, "%s/" HASH_PRINT_FORMAT, AOT_CACHE_DIR, hash(code_, strlen(code_)));
+
+    char filename[MAX_STR_LEN] = "";
+    sprintf(filename, "%s.so", basename);
+
+    if (Load(filename)) return;
+
+    compiled_ = Build(basename);
+    if (compiled_) Load(filename);
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+Aot::~Aot ()
+{
+    if (state_ != CALC_OK) return;
+
+#if defined (AOT_SUPPORTED)
+    if (handle_ != nullptr) dlclose(handle_);
+#endif
+
+    delete [] code_;
+
+    code_   = nullptr;
+    handle_ = nullptr;
+    func_   = nullptr;
+
+    state_ = CALC_DESTRUCTED;
+}
+
+//------------------------------------------------------------------------------
+
+bool Aot::Load (const char* filename)
+{
+    assert(filename != nullptr);
+
+#if defined (AOT_SUPPORTED)
+    void* handle = dlopen(filename, RTLD_NOW | RTLD_LOCAL);
+    if (handle == nullptr) return false;
+
+    /* hashes may collide, so the object keeps the expression it was built from */
+    const char* expr = (const char*)dlsym(handle, AOT_EXPR_NAME);
+    JitFunc     func = (JitFunc)    dlsym(handle, AOT_FUNC_NAME);
+
+    if ((expr == nullptr) || (func == nullptr) || (strcmp(expr, code_) != 0))
+    {
+        dlclose(handle);
+        return false;
+    }
+
+    handle_ = handle;
+    func_   = func;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+bool Aot::Build (const char* basename)
+{
+    assert(basename != nullptr);
+
+#if defined (AOT_SUPPORTED)
+    mkdir(AOT_CACHE_DIR, 0755);
+
+    char srcname[MAX_STR_LEN] = "";
+    sprintf(srcname, "%s.cpp", basename);
+
+    FILE* src = fopen(srcname, "w");
+    if (src == nullptr) return false;
+
+    fprintf(src, "%s", AOT_PREAMBLE);
+    fprintf(src, "extern \"C\" const char %s[] = \"%s\";\n\n", AOT_EXPR_NAME, code_);
+    fprintf(src, "extern \"C\" calc::num %s (const calc::num* v)\n", AOT_FUNC_NAME);
+    fprintf(src, "{\n");
+    fprintf(src, "    using namespace calc;\n");
+    fprintf(src, "    return %s;\n", code_);
+    fprintf(src, "}\n");
+    fclose(src);
+
+    /* build to the temporary name, so other processes never load a half-written object */
+    char tmpname[MAX_STR_LEN] = "";
+    sprintf(tmpname, "%s.so.%d", basename, (int)getpid());
+
+    char command[3 * MAX_STR_LEN] = "";
+    sprintf(command, "%s -o %s %s 2>> %s", AOT_COMPILER, tmpname, srcname, CALCULATOR_LOGNAME);
+
+    if (system(command) != 0)
+    {
+        remove(tmpname);
+        return false;
+    }
+
+    char filename[MAX_STR_LEN] = "";
+    sprintf(filename, "%s.so", basename);
+
+    return rename(tmpname, filename) == 0;
+#else
+    return false;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+static void InfixCode (Node<CalcNodeData>* node_cur, char** str)
+{
+    if (node_cur->getData().op_code == OP_POW)
+        *str += sprintf(*str, ",");
+    else
+        *str += sprintf(*str, "%s", node_cur->getData().word);
+}
+
+//------------------------------------------------------------------------------
+
+int Node2Code (Node<CalcNodeData>* root, Program& program, char** str)
+{
+    assert(root != nullptr);
+    assert(*str != nullptr);
+
+    /* walk by prev_, from tells where the walk came from, nullptr is the parent */
+    Node<CalcNodeData>* node_cur = root;
+    Node<CalcNodeData>* from     = nullptr;
+
+    while (true)
+    {
+        Node<CalcNodeData>* next = nullptr;
+
+        if (from == nullptr)
+        {
+            switch (node_cur->getData().node_type)
+            {
+            case NODE_FUNCTION:
+            {
+                if ((node_cur->right_ == nullptr) || (node_cur->left_ != nullptr))
+                    return CALC_TREE_FUNC_WRONG_ARGUMENT;
+
+                *str += sprintf(*str, "%s(", node_cur->getData().word);
+                next = node_cur->right_;
+                break;
+            }
+            case NODE_OPERATOR:
+            {
+                if ((node_cur->right_ == nullptr) ||
+                    ((node_cur->left_ == nullptr) && (node_cur->getData().op_code != OP_SUB)))
+                    return CALC_TREE_OPER_WRONG_ARGUMENTS;
+
+                if (node_cur->getData().op_code == OP_POW)
+                    *str += sprintf(*str, "pow(");
+                else
+                    *str += sprintf(*str, "(");
+
+                if (node_cur->left_ != nullptr)
+                    next = node_cur->left_;
+                else
+                {
+                    *str += sprintf(*str, "num(0)");
+                    InfixCode(node_cur, str);
+                    next = node_cur->right_;
+                }
+                break;
+            }
+            case NODE_VARIABLE:
+            {
+                if ((node_cur->right_ != nullptr) || (node_cur->left_ != nullptr))
+                    return CALC_TREE_VAR_WRONG_ARGUMENT;
+
+                *str += sprintf(*str, "v[%u]", program.findVar(node_cur->getData().word, node_cur->getData().symbol));
+                break;
+            }
+            case NODE_NUMBER:
+            {
+                if ((node_cur->right_ != nullptr) || (node_cur->left_ != nullptr))
+                    return CALC_TREE_NUM_WRONG_ARGUMENT;
+
+                /* hexadecimal floats keep the numbers exact */
+                NUM_TYPE number = node_cur->getData().number;
+                *str += sprintf(*str, "num(%a,%a)", real(number), imag(number));
+                break;
+            }
+            default: assert(0);
+            }
+        }
+        else
+        if (from == node_cur->left_)
+        {
+            InfixCode(node_cur, str);
+            next = node_cur->right_;
+        }
+        else
+            *str += sprintf(*str, ")");
+
+        if (next != nullptr)
+        {
+            node_cur = next;
+            from     = nullptr;
+            continue;
+        }
+
+        if (node_cur == root) break;
+
+        from     = node_cur;
+        node_cur = node_cur->prev_;
+    }
+
+    return CALC_OK;
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,119 @@
+/*------------------------------------------------------------------------------
+    * File:        Aot.h                                                       *
+    * Description: Declaration of the ahead-of-time C++ code generator for     *
+    *              expression trees with the on-disk cache of shared objects.  *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+#ifndef AOT_H_INCLUDED
+#define AOT_H_INCLUDED
+
+#include "Jit.h"
+#include "../StackLib/hash.h"
+
+#if defined (__linux__)
+    #define AOT_SUPPORTED
+#endif
+
+
+//==============================================================================
+/*------------------------------------------------------------------------------
+                   Aot constants and types                                     *
+*///----------------------------------------------------------------------------
+//==============================================================================
+
+
+char const * const AOT_CACHE_DIR = ".calc_cache";
+char const * const AOT_COMPILER  = "g++ -O2 -shared -fPIC";
+char const * const AOT_FUNC_NAME = "calc_func";
+char const * const AOT_EXPR_NAME = "calc_expr";
+
+
+class Aot
+{
+    int state_;
+
+    void* handle_ = nullptr;
+
+public:
+
+    Program program_;
+    JitFunc func_ = nullptr;
+
+    char*   code_     = nullptr;
+    bool    compiled_ = false;
+
+//------------------------------------------------------------------------------
+/*! @brief   Load the native code of the tree from the cache or build it.
+ *
+ *  @param   tree        Equation tree
+ *
+ *  @note    func_ stays nullptr if the compiler or dlopen failed.
+ */
+
+    Aot (Tree<CalcNodeData>& tree);
+
+//------------------------------------------------------------------------------
+/*! @brief   Aot copy constructor (deleted).
+ *
+ *  @param   obj         Source aot
+ */
+
+    Aot (const Aot& obj);
+
+    Aot& operator = (const Aot& obj); // deleted
+
+//------------------------------------------------------------------------------
+/*! @brief   Aot destructor.
+ */
+
+   ~Aot ();
+
+/*------------------------------------------------------------------------------
+                   Private functions                                           *
+*///----------------------------------------------------------------------------
+
+private:
+
+//------------------------------------------------------------------------------
+/*! @brief   Open the shared object and check it was built from code_.
+ *
+ *  @param   filename    Name of the shared object
+ *
+ *  @return  true if the function is loaded, else false
+ */
+
+    bool Load (const char* filename);
+
+//------------------------------------------------------------------------------
+/*! @brief   Write the source file and compile it to the shared object.
+ *
+ *  @param   basename    Name of the files without extension
+ *
+ *  @return  true if compiled, else false
+ */
+
+    bool Build (const char* basename);
+
+//------------------------------------------------------------------------------
+};
+
+//------------------------------------------------------------------------------
+/*! @brief   Convert tree node to C++ expression over the array of variables.
+ *
+ *  @param   root        Root of the subtree
+ *  @param   program     Program of the tree with slots of variables
+ *  @param   str         C string
+ *
+ *  @return  error code
+ */
+
+int Node2Code (Node<CalcNodeData>* root, Program& program, char** str);
+
+//------------------------------------------------------------------------------
+
+#endif // AOT_H_INCLUDED
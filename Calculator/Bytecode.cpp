@@ -0,0 +1,761 @@
+/*------------------------------------------------------------------------------
+    * File:        Bytecode.cpp                                                *
+    * Description: Compiler of expression trees to the register bytecode and   *
+    *              the interpreter for it.                                     *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+#include "Bytecode.h"
+#include "ExprFile.h"
+
+//------------------------------------------------------------------------------
+
+Program::Program () : state_ (CALC_NOT_OK) {}
+
+//------------------------------------------------------------------------------
+
+Program::Program (Tree<CalcNodeData>& tree) :
+    state_ (CALC_OK)
+{
+    if (tree.root_ == nullptr)
+    {
+        state_ = CALC_NOT_OK;
+        return;
+    }
+
+    nodes_num_ = CountNodes(tree.root_);
+
+    /* one extra instruction per unary minus at most */
+    code_   = new Instruction[2 * nodes_num_] {};
+    consts_ = new NUM_TYPE   [2 * nodes_num_] {};
+    vars_   = new char*      [nodes_num_]     {};
+
+    var_symbols_ = new uint32_t[nodes_num_] {};
+    var_slots_   = new int     [nodes_num_] {};
+
+    table_size_   = 1;
+    while (table_size_ < 4 * nodes_num_) table_size_ *= 2;
+
+    code_table_   = new unsigned[table_size_] {};
+    consts_table_ = new unsigned[table_size_] {};
+
+    unsigned root = 0;
+    int err = Compile(tree.root_, root);
+
+    delete [] code_table_;
+    delete [] consts_table_;
+    code_table_   = nullptr;
+    consts_table_ = nullptr;
+
+    /* a broken tree is not a reason to exit, the caller checks getErrCode */
+    if (err)
+    {
+        state_ = err;
+        return;
+    }
+
+    Allocate(root);
+
+    regs_ = new NUM_TYPE[regs_num_] {};
+
+    real_regs_   = new double[regs_num_]      {};
+    real_consts_ = new double[2 * nodes_num_] {};
+
+    for (size_t i = 0; i < consts_num_; ++i)
+    {
+        if (imag(consts_[i]) != 0) is_real_ = false;
+
+        real_consts_[i] = real(consts_[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+Program::Program (const ExprFile& file, size_t index) :
+    state_ (CALC_OK)
+{
+    assert(index < file.exprs_num_);
+
+    const ExprFileEntry& expr = file.exprs_[index];
+    if (expr.code_num == 0)
+    {
+        state_ = CALC_NOT_OK;
+        return;
+    }
+
+    /* the file is checked, the code is taken as it is */
+    nodes_num_  = expr.nodes_num;
+    size_       = expr.code_num;
+    consts_num_ = expr.consts_num;
+    regs_num_   = expr.regs_num;
+
+    /* setConstVar adds one constant per variable at most */
+    size_t consts_max = consts_num_ + expr.vars_num + 1;
+
+    code_   = new Instruction[size_];
+    consts_ = new NUM_TYPE   [consts_max] {};
+
+    memcpy(code_,   file.code_   + expr.code_begin,   size_       * sizeof(Instruction));
+    memcpy(consts_, file.consts_ + expr.consts_begin, consts_num_ * sizeof(NUM_TYPE));
+
+    vars_        = new char*   [expr.vars_num + 1] {};
+    var_symbols_ = new uint32_t[expr.vars_num + 1] {};
+    var_slots_   = new int     [expr.vars_num + 1] {};
+
+    /* variables keep the order of the file, BC_VARIABLE refers to them by it */
+    vars_num_ = expr.vars_num;
+    for (size_t i = 0; i < vars_num_; ++i)
+    {
+        const char* name = file.names_ + file.vars_[expr.vars_begin + i];
+
+        vars_[i]      = internName(name, strlen(name), var_symbols_[i]);
+        var_slots_[i] = -1;
+    }
+
+    regs_ = new NUM_TYPE[regs_num_] {};
+
+    real_regs_   = new double[regs_num_]       {};
+    real_consts_ = new double[consts_max]      {};
+
+    for (size_t i = 0; i < consts_num_; ++i)
+    {
+        if (imag(consts_[i]) != 0) is_real_ = false;
+
+        real_consts_[i] = real(consts_[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+Program::~Program ()
+{
+    /* arrays of a program that failed to compile are freed too */
+    if (state_ == CALC_DESTRUCTED) return;
+
+    delete [] code_;
+    delete [] consts_;
+    delete [] vars_;
+    delete [] var_symbols_;
+    delete [] var_slots_;
+    delete [] regs_;
+    delete [] real_consts_;
+    delete [] real_regs_;
+
+    code_        = nullptr;
+    consts_      = nullptr;
+    vars_        = nullptr;
+    var_symbols_ = nullptr;
+    var_slots_   = nullptr;
+    regs_        = nullptr;
+    real_consts_ = nullptr;
+    real_regs_   = nullptr;
+
+    state_ = CALC_DESTRUCTED;
+}
+
+//------------------------------------------------------------------------------
+
+int Program::Compile (Node<CalcNodeData>* root, unsigned& value)
+{
+    assert(root != nullptr);
+
+    /* instructions of the finished subtrees wait here for their parent */
+    unsigned* done     = new unsigned[2 * nodes_num_];
+    size_t    done_num = 0;
+
+    /* the zero of a unary minus is emitted before its operand, where the left operand would be */
+    auto descend = [&] (Node<CalcNodeData>* node_cur)
+    {
+        while (true)
+        {
+            if (node_cur->left_ != nullptr)
+                node_cur = node_cur->left_;
+            else
+            if (node_cur->right_ != nullptr)
+            {
+                if (node_cur->getData().node_type == NODE_OPERATOR)
+                    done[done_num++] = AddInstruction({ 0, AddConst(0), 0, BC_NUMBER });
+
+                node_cur = node_cur->right_;
+            }
+            else
+                return node_cur;
+        }
+    };
+
+    int err = CALC_OK;
+
+    /* post-order walk by prev_, deep trees do not grow the call stack */
+    Node<CalcNodeData>* node_cur = descend(root);
+    while (true)
+    {
+        const CalcNodeData& data = node_cur->getData();
+
+        switch (data.node_type)
+        {
+        case NODE_FUNCTION:
+        {
+            if ((node_cur->right_ == nullptr) || (node_cur->left_ != nullptr))
+            {
+                err = CALC_TREE_FUNC_WRONG_ARGUMENT;
+                break;
+            }
+
+            unsigned arg = done[--done_num];
+            value = AddInstruction({ 0, 0, arg, data.op_code });
+            break;
+        }
+        case NODE_OPERATOR:
+        {
+            if ((node_cur->right_ == nullptr) ||
+                ((node_cur->left_ == nullptr) && (data.op_code != OP_SUB)))
+            {
+                err = CALC_TREE_OPER_WRONG_ARGUMENTS;
+                break;
+            }
+
+            unsigned right = done[--done_num];
+            unsigned left  = done[--done_num];
+            value = AddInstruction({ 0, left, right, data.op_code });
+            break;
+        }
+        case NODE_VARIABLE:
+        {
+            if ((node_cur->right_ != nullptr) || (node_cur->left_ != nullptr))
+            {
+                err = CALC_TREE_VAR_WRONG_ARGUMENT;
+                break;
+            }
+
+            unsigned var = findVar(data.word, data.symbol);
+            var_slots_[var] = data.slot;
+
+            value = AddInstruction({ 0, var, 0, BC_VARIABLE });
+            break;
+        }
+        case NODE_NUMBER:
+        {
+            if ((node_cur->right_ != nullptr) || (node_cur->left_ != nullptr))
+            {
+                err = CALC_TREE_NUM_WRONG_ARGUMENT;
+                break;
+            }
+
+            value = AddInstruction({ 0, AddConst(data.number), 0, BC_NUMBER });
+            break;
+        }
+        default: assert(0);
+        }
+
+        if (err || (node_cur == root)) break;
+
+        done[done_num++] = value;
+
+        Node<CalcNodeData>* prev = node_cur->prev_;
+        if ((node_cur == prev->left_) && (prev->right_ != nullptr))
+            node_cur = descend(prev->right_);
+        else
+            node_cur = prev;
+    }
+
+    delete [] done;
+
+    return err;
+}
+
+//------------------------------------------------------------------------------
+
+static bool isBinary (char code)
+{
+    return (OP_ADD <= code) && (code <= OP_POW);
+}
+
+//------------------------------------------------------------------------------
+
+static size_t mixHash (uint64_t first, uint64_t second)
+{
+    uint64_t hsh = (first ^ (second * 0x9E3779B97F4A7C15ull)) * 0xBF58476D1CE4E5B9ull;
+
+    return hsh ^ (hsh >> 31);
+}
+
+//------------------------------------------------------------------------------
+
+unsigned Program::AddInstruction (Instruction ins)
+{
+    size_t index = mixHash(((uint64_t)ins.left << 8) | (unsigned char)ins.code, ins.right) & (table_size_ - 1);
+
+    for (; code_table_[index] != 0; index = (index + 1) & (table_size_ - 1))
+    {
+        const Instruction& old = code_[code_table_[index] - 1];
+        if ((old.code == ins.code) && (old.left == ins.left) && (old.right == ins.right))
+            return code_table_[index] - 1;
+    }
+
+    ins.dst = size_;
+    code_[size_++] = ins;
+    code_table_[index] = size_;
+
+    return ins.dst;
+}
+
+//------------------------------------------------------------------------------
+
+unsigned Program::AddConst (NUM_TYPE number)
+{
+    uint64_t bits[2] = {};
+    memcpy(bits, &number, sizeof(bits));
+
+    size_t index = mixHash(bits[0], bits[1]) & (table_size_ - 1);
+
+    for (; consts_table_[index] != 0; index = (index + 1) & (table_size_ - 1))
+        if (memcmp(&consts_[consts_table_[index] - 1], &number, NUM_TYPE_SIZE) == 0)
+            return consts_table_[index] - 1;
+
+    consts_[consts_num_++] = number;
+    consts_table_[index] = consts_num_;
+
+    return consts_num_ - 1;
+}
+
+//------------------------------------------------------------------------------
+
+void Program::Allocate (unsigned root)
+{
+    assert(root + 1 == size_);
+
+    /* values are numbered by their instructions, find the last read of each */
+    size_t* last_use = new size_t[size_] {};
+    last_use[root] = size_;
+
+    for (size_t i = 0; i < size_; ++i)
+    {
+        const Instruction& ins = code_[i];
+        if ((ins.code == BC_NUMBER) || (ins.code == BC_VARIABLE)) continue;
+
+        if (isBinary(ins.code)) last_use[ins.left] = i;
+        last_use[ins.right] = i;
+    }
+
+    unsigned* value_reg = new unsigned[size_] {};
+    unsigned* free_regs = new unsigned[size_] {};
+    size_t    free_num  = 0;
+
+    for (size_t i = 0; i < size_; ++i)
+    {
+        Instruction& ins = code_[i];
+
+        if ((ins.code != BC_NUMBER) && (ins.code != BC_VARIABLE))
+        {
+            unsigned left   = ins.left;
+            unsigned right  = ins.right;
+            bool     binary = isBinary(ins.code);
+
+            if (binary) ins.left = value_reg[left];
+            ins.right = value_reg[right];
+
+            if (binary && (last_use[left] == i))
+                free_regs[free_num++] = ins.left;
+
+            if ((last_use[right] == i) && not (binary && (left == right)))
+                free_regs[free_num++] = ins.right;
+        }
+
+        /* operands are read before the result is written, so it may take their register */
+        ins.dst = (free_num > 0) ? free_regs[--free_num] : regs_num_++;
+        value_reg[i] = ins.dst;
+    }
+
+    /* the result of the program is always in the register 0 */
+    unsigned result = value_reg[root];
+    for (size_t i = 0; i < size_; ++i)
+    {
+        Instruction& ins = code_[i];
+
+        #define SWAP_REG(reg) do                                            \
+                              {                                             \
+                                  if      (reg == result) { reg = 0;      } \
+                                  else if (reg == 0)      { reg = result; } \
+                              } while (0)
+
+        SWAP_REG(ins.dst);
+        if ((ins.code != BC_NUMBER) && (ins.code != BC_VARIABLE))
+        {
+            if (isBinary(ins.code)) SWAP_REG(ins.left);
+            SWAP_REG(ins.right);
+        }
+
+        #undef SWAP_REG
+    }
+
+    delete [] last_use;
+    delete [] value_reg;
+    delete [] free_regs;
+}
+
+//------------------------------------------------------------------------------
+
+unsigned Program::findVar (char* varname, uint32_t symbol)
+{
+    assert(varname != nullptr);
+
+    for (size_t i = 0; i < vars_num_; ++i)
+        if (var_symbols_[i] == symbol)
+            return i;
+
+    vars_       [vars_num_] = varname;
+    var_symbols_[vars_num_] = symbol;
+
+    return vars_num_++;
+}
+
+//------------------------------------------------------------------------------
+
+#define BC_OPERATOR(op) case op: regs[ins->dst] = calcOperator(op, regs[ins->left], regs[ins->right]); break;
+#define BC_FUNCTION(op) case op: regs[ins->dst] = calcFunction(op, regs[ins->right]);                 break;
+
+NUM_TYPE Program::Execute (const NUM_TYPE* vars)
+{
+    assert(state_ == CALC_OK);
+
+    NUM_TYPE number = 0;
+    if (real_mode_ && is_real_ && ExecuteReal(vars, number))
+        return number;
+
+    NUM_TYPE*       regs   = regs_;
+    const NUM_TYPE* consts = consts_;
+
+    for (const Instruction* ins = code_, * end = code_ + size_; ins != end; ++ins)
+    {
+        switch (ins->code)
+        {
+        case BC_NUMBER:   regs[ins->dst] = consts[ins->left]; break;
+        case BC_VARIABLE: regs[ins->dst] = vars  [ins->left]; break;
+
+        BC_OPERATOR(OP_ADD)
+        BC_OPERATOR(OP_SUB)
+        BC_OPERATOR(OP_MUL)
+        BC_OPERATOR(OP_DIV)
+        BC_OPERATOR(OP_POW)
+
+        BC_FUNCTION(OP_ARCCOS)
+        BC_FUNCTION(OP_ARCCOSH)
+        BC_FUNCTION(OP_ARCCOT)
+        BC_FUNCTION(OP_ARCCOTH)
+        BC_FUNCTION(OP_ARCSIN)
+        BC_FUNCTION(OP_ARCSINH)
+        BC_FUNCTION(OP_ARCTAN)
+        BC_FUNCTION(OP_ARCTANH)
+        BC_FUNCTION(OP_COS)
+        BC_FUNCTION(OP_COSH)
+        BC_FUNCTION(OP_COT)
+        BC_FUNCTION(OP_COTH)
+        BC_FUNCTION(OP_EXP)
+        BC_FUNCTION(OP_LG)
+        BC_FUNCTION(OP_LN)
+        BC_FUNCTION(OP_SIN)
+        BC_FUNCTION(OP_SINH)
+        BC_FUNCTION(OP_SQRT)
+        BC_FUNCTION(OP_TAN)
+        BC_FUNCTION(OP_TANH)
+
+        default: assert(0);
+        }
+    }
+
+    return regs[0];
+}
+
+#undef BC_OPERATOR
+#undef BC_FUNCTION
+
+//------------------------------------------------------------------------------
+
+#define BC_OPERATOR(op) case op: regs[ins->dst] = calcOperator(op, regs[ins->left], regs[ins->right]); break;
+#define BC_FUNCTION(op) case op: regs[ins->dst] = calcFunction(op, regs[ins->right]);                 break;
+
+bool Program::ExecuteReal (const NUM_TYPE* vars, NUM_TYPE& number)
+{
+    for (size_t i = 0; i < vars_num_; ++i)
+        if (imag(vars[i]) != 0) return false;
+
+    double*       regs   = real_regs_;
+    const double* consts = real_consts_;
+
+    for (const Instruction* ins = code_, * end = code_ + size_; ins != end; ++ins)
+    {
+        switch (ins->code)
+        {
+        case BC_NUMBER:   regs[ins->dst] = consts[ins->left];     break;
+        case BC_VARIABLE: regs[ins->dst] = real(vars[ins->left]); break;
+
+        BC_OPERATOR(OP_ADD)
+        BC_OPERATOR(OP_SUB)
+        BC_OPERATOR(OP_MUL)
+        BC_OPERATOR(OP_DIV)
+        BC_OPERATOR(OP_POW)
+
+        BC_FUNCTION(OP_ARCCOS)
+        BC_FUNCTION(OP_ARCCOSH)
+        BC_FUNCTION(OP_ARCCOT)
+        BC_FUNCTION(OP_ARCCOTH)
+        BC_FUNCTION(OP_ARCSIN)
+        BC_FUNCTION(OP_ARCSINH)
+        BC_FUNCTION(OP_ARCTAN)
+        BC_FUNCTION(OP_ARCTANH)
+        BC_FUNCTION(OP_COS)
+        BC_FUNCTION(OP_COSH)
+        BC_FUNCTION(OP_COT)
+        BC_FUNCTION(OP_COTH)
+        BC_FUNCTION(OP_EXP)
+        BC_FUNCTION(OP_LG)
+        BC_FUNCTION(OP_LN)
+        BC_FUNCTION(OP_SIN)
+        BC_FUNCTION(OP_SINH)
+        BC_FUNCTION(OP_SQRT)
+        BC_FUNCTION(OP_TAN)
+        BC_FUNCTION(OP_TANH)
+
+        default: assert(0);
+        }
+
+        /* NaN means the value left the reals, infinity behaves differently in complex */
+        if (not isfinite(regs[ins->dst])) return false;
+    }
+
+    number = regs[0];
+
+    return true;
+}
+
+#undef BC_OPERATOR
+#undef BC_FUNCTION
+
+//------------------------------------------------------------------------------
+
+void Program::ExecuteBatch (const NUM_TYPE* const* columns, NUM_TYPE* output, size_t rows_num, int threads_num)
+{
+    assert(state_ == CALC_OK);
+    assert(output != nullptr);
+    assert(threads_num >= 0);
+
+    if (threads_num == 0) threads_num = omp_get_max_threads();
+
+    long long blocks_num = (rows_num + BATCH_BLOCK - 1) / BATCH_BLOCK;
+
+    #pragma omp parallel num_threads(threads_num) if (blocks_num > 1)
+    {
+        NUM_TYPE* scratch = new NUM_TYPE[regs_num_ * BATCH_BLOCK];
+
+        #pragma omp for schedule(static)
+        for (long long block_i = 0; block_i < blocks_num; ++block_i)
+        {
+            size_t begin = block_i * BATCH_BLOCK;
+            size_t block = (rows_num - begin < BATCH_BLOCK) ? rows_num - begin : BATCH_BLOCK;
+
+            if (not (real_mode_ && is_real_ && ExecuteBlockReal(columns, output, begin, block, (double*)scratch)))
+                ExecuteBlock(columns, output, begin, block, scratch);
+        }
+
+        delete [] scratch;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+#define BC_OPERATOR(op) case op: for (size_t i = 0; i < rows_num; ++i) dst[i] = calcOperator(op, left[i], right[i]); break;
+#define BC_FUNCTION(op) case op: for (size_t i = 0; i < rows_num; ++i) dst[i] = calcFunction(op, right[i]);         break;
+
+void Program::ExecuteBlock (const NUM_TYPE* const* columns, NUM_TYPE* output, size_t begin, size_t rows_num, NUM_TYPE* scratch)
+{
+    assert(state_ == CALC_OK);
+    assert(rows_num <= BATCH_BLOCK);
+    assert(scratch != nullptr);
+
+    for (const Instruction* ins = code_, * end = code_ + size_; ins != end; ++ins)
+    {
+        NUM_TYPE*       dst   = scratch + ins->dst   * BATCH_BLOCK;
+        const NUM_TYPE* left  = scratch + ins->left  * BATCH_BLOCK;
+        const NUM_TYPE* right = scratch + ins->right * BATCH_BLOCK;
+
+        switch (ins->code)
+        {
+        case BC_NUMBER:
+        {
+            NUM_TYPE number = consts_[ins->left];
+            for (size_t i = 0; i < rows_num; ++i) dst[i] = number;
+            break;
+        }
+        case BC_VARIABLE:
+        {
+            assert(columns[ins->left] != nullptr);
+            memcpy(dst, columns[ins->left] + begin, rows_num * NUM_TYPE_SIZE);
+            break;
+        }
+
+        BC_OPERATOR(OP_ADD)
+        BC_OPERATOR(OP_SUB)
+        BC_OPERATOR(OP_MUL)
+        BC_OPERATOR(OP_DIV)
+        BC_OPERATOR(OP_POW)
+
+        BC_FUNCTION(OP_ARCCOS)
+        BC_FUNCTION(OP_ARCCOSH)
+        BC_FUNCTION(OP_ARCCOT)
+        BC_FUNCTION(OP_ARCCOTH)
+        BC_FUNCTION(OP_ARCSIN)
+        BC_FUNCTION(OP_ARCSINH)
+        BC_FUNCTION(OP_ARCTAN)
+        BC_FUNCTION(OP_ARCTANH)
+        BC_FUNCTION(OP_COS)
+        BC_FUNCTION(OP_COSH)
+        BC_FUNCTION(OP_COT)
+        BC_FUNCTION(OP_COTH)
+        BC_FUNCTION(OP_EXP)
+        BC_FUNCTION(OP_LG)
+        BC_FUNCTION(OP_LN)
+        BC_FUNCTION(OP_SIN)
+        BC_FUNCTION(OP_SINH)
+        BC_FUNCTION(OP_SQRT)
+        BC_FUNCTION(OP_TAN)
+        BC_FUNCTION(OP_TANH)
+
+        default: assert(0);
+        }
+    }
+
+    memcpy(output + begin, scratch, rows_num * NUM_TYPE_SIZE);
+}
+
+#undef BC_OPERATOR
+#undef BC_FUNCTION
+
+//------------------------------------------------------------------------------
+
+#define BC_OPERATOR(op) case op: for (size_t i = 0; i < rows_num; ++i) dst[i] = calcOperator(op, left[i], right[i]); break;
+#define BC_FUNCTION(op) case op: for (size_t i = 0; i < rows_num; ++i) dst[i] = calcFunction(op, right[i]);         break;
+
+bool Program::ExecuteBlockReal (const NUM_TYPE* const* columns, NUM_TYPE* output, size_t begin, size_t rows_num, double* scratch)
+{
+    assert(rows_num <= BATCH_BLOCK);
+    assert(scratch != nullptr);
+
+    for (const Instruction* ins = code_, * end = code_ + size_; ins != end; ++ins)
+    {
+        double*       dst   = scratch + ins->dst   * BATCH_BLOCK;
+        const double* left  = scratch + ins->left  * BATCH_BLOCK;
+        const double* right = scratch + ins->right * BATCH_BLOCK;
+
+        switch (ins->code)
+        {
+        case BC_NUMBER:
+        {
+            double number = real_consts_[ins->left];
+            for (size_t i = 0; i < rows_num; ++i) dst[i] = number;
+            break;
+        }
+        case BC_VARIABLE:
+        {
+            assert(columns[ins->left] != nullptr);
+
+            const NUM_TYPE* column = columns[ins->left] + begin;
+            bool is_real = true;
+            for (size_t i = 0; i < rows_num; ++i)
+            {
+                dst[i] = real(column[i]);
+                is_real &= (imag(column[i]) == 0);
+            }
+
+            if (not is_real) return false;
+            break;
+        }
+
+        BC_OPERATOR(OP_ADD)
+        BC_OPERATOR(OP_SUB)
+        BC_OPERATOR(OP_MUL)
+        BC_OPERATOR(OP_DIV)
+        BC_OPERATOR(OP_POW)
+
+        BC_FUNCTION(OP_ARCCOS)
+        BC_FUNCTION(OP_ARCCOSH)
+        BC_FUNCTION(OP_ARCCOT)
+        BC_FUNCTION(OP_ARCCOTH)
+        BC_FUNCTION(OP_ARCSIN)
+        BC_FUNCTION(OP_ARCSINH)
+        BC_FUNCTION(OP_ARCTAN)
+        BC_FUNCTION(OP_ARCTANH)
+        BC_FUNCTION(OP_COS)
+        BC_FUNCTION(OP_COSH)
+        BC_FUNCTION(OP_COT)
+        BC_FUNCTION(OP_COTH)
+        BC_FUNCTION(OP_EXP)
+        BC_FUNCTION(OP_LG)
+        BC_FUNCTION(OP_LN)
+        BC_FUNCTION(OP_SIN)
+        BC_FUNCTION(OP_SINH)
+        BC_FUNCTION(OP_SQRT)
+        BC_FUNCTION(OP_TAN)
+        BC_FUNCTION(OP_TANH)
+
+        default: assert(0);
+        }
+
+        bool is_finite = true;
+        for (size_t i = 0; i < rows_num; ++i)
+            is_finite &= (bool)isfinite(dst[i]);
+
+        if (not is_finite) return false;
+    }
+
+    for (size_t i = 0; i < rows_num; ++i)
+        output[begin + i] = scratch[i];
+
+    return true;
+}
+
+#undef BC_OPERATOR
+#undef BC_FUNCTION
+
+//------------------------------------------------------------------------------
+
+void Program::setConstVar (unsigned slot, NUM_TYPE value)
+{
+    assert(slot < vars_num_);
+
+    consts_     [consts_num_] = value;
+    real_consts_[consts_num_] = real(value);
+
+    if (imag(value) != 0) is_real_ = false;
+
+    for (size_t i = 0; i < size_; ++i)
+        if ((code_[i].code == BC_VARIABLE) && (code_[i].left == slot))
+            code_[i] = { code_[i].dst, (unsigned)consts_num_, 0, BC_NUMBER };
+
+    ++consts_num_;
+}
+
+//------------------------------------------------------------------------------
+
+int Program::getErrCode ()
+{
+    return state_;
+}
+
+//------------------------------------------------------------------------------
+
+size_t CountNodes (Node<CalcNodeData>* root)
+{
+    if (root == nullptr) return 0;
+
+    size_t nodes_num = 0;
+    for (Node<CalcNodeData>* node_cur = root->firstPostorder(); node_cur != nullptr; node_cur = node_cur->nextPostorder(root))
+        ++nodes_num;
+
+    return nodes_num;
+}
+
+//------------------------------------------------------------------------------
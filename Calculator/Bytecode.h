@@ -0,0 +1,265 @@
+/*------------------------------------------------------------------------------
+    * File:        Bytecode.h                                                  *
+    * Description: Declaration of the flat register bytecode for expression    *
+    *              trees and the interpreter for it.                           *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+#ifndef BYTECODE_H_INCLUDED
+#define BYTECODE_H_INCLUDED
+
+#include "Calculator.h"
+
+
+//==============================================================================
+/*------------------------------------------------------------------------------
+                   Bytecode constants and types                                *
+*///----------------------------------------------------------------------------
+//==============================================================================
+
+
+const size_t BATCH_BLOCK = 256;
+
+class ExprFile;
+
+enum BytecodeCodes
+{
+    BC_NUMBER   = OP_TANH + 1,
+    BC_VARIABLE = OP_TANH + 2,
+};
+
+struct Instruction
+{
+    unsigned dst   = 0;
+    unsigned left  = 0;
+    unsigned right = 0;
+    char     code  = OP_ERR;
+};
+
+
+class Program
+{
+    int state_;
+
+    unsigned* code_table_   = nullptr;
+    unsigned* consts_table_ = nullptr;
+    size_t    table_size_   = 0;
+
+public:
+
+    Instruction* code_     = nullptr;
+    size_t       size_     = 0;
+
+    NUM_TYPE*    consts_     = nullptr;
+    size_t       consts_num_ = 0;
+
+    char**       vars_        = nullptr;
+    uint32_t*    var_symbols_ = nullptr;
+    int*         var_slots_   = nullptr;
+    size_t       vars_num_    = 0;
+
+    NUM_TYPE*    regs_     = nullptr;
+    size_t       regs_num_ = 0;
+
+    size_t       nodes_num_ = 0;
+
+    double*      real_consts_ = nullptr;
+    double*      real_regs_   = nullptr;
+
+    bool         is_real_   = true;
+    bool         real_mode_ = true;
+
+//------------------------------------------------------------------------------
+/*! @brief   Program default constructor.
+ */
+
+    Program ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Compile expression tree to the program.
+ *
+ *  @param   tree        Equation tree
+ *
+ *  @note    Variable names are borrowed from the tree nodes.
+ */
+
+    Program (Tree<CalcNodeData>& tree);
+
+//------------------------------------------------------------------------------
+/*! @brief   Take the compiled program of the expression from the file.
+ *
+ *  @param   file        Checked file of compiled expressions
+ *  @param   index       Index of the expression, its program must be kept
+ */
+
+    Program (const ExprFile& file, size_t index);
+
+//------------------------------------------------------------------------------
+/*! @brief   Program copy constructor (deleted).
+ *
+ *  @param   obj         Source program
+ */
+
+    Program (const Program& obj);
+
+    Program& operator = (const Program& obj); // deleted
+
+//------------------------------------------------------------------------------
+/*! @brief   Program destructor.
+ */
+
+   ~Program ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Run the program.
+ *
+ *  @param   vars        Values of variables in order of vars_
+ *
+ *  @return  result of the expression
+ */
+
+    NUM_TYPE Execute (const NUM_TYPE* vars);
+
+//------------------------------------------------------------------------------
+/*! @brief   Run the program over the columns of variables.
+ *
+ *  @param   columns     Columns of variable values in order of vars_
+ *  @param   output      Array for results
+ *  @param   rows_num    Number of rows
+ *  @param   threads_num Number of threads, 0 - all available cores
+ */
+
+    void ExecuteBatch (const NUM_TYPE* const* columns, NUM_TYPE* output, size_t rows_num, int threads_num = 1);
+
+//------------------------------------------------------------------------------
+/*! @brief   Run the program over one block of rows, instruction by instruction.
+ *
+ *  @param   columns     Columns of variable values in order of vars_
+ *  @param   output      Array for results
+ *  @param   begin       First row of the block
+ *  @param   rows_num    Number of rows in the block (not more than BATCH_BLOCK)
+ *  @param   scratch     Registers memory, regs_num_ * BATCH_BLOCK numbers
+ */
+
+    void ExecuteBlock (const NUM_TYPE* const* columns, NUM_TYPE* output, size_t begin, size_t rows_num, NUM_TYPE* scratch);
+
+//------------------------------------------------------------------------------
+/*! @brief   Replace loads of the variable with the constant value.
+ *
+ *  @param   slot        Slot of the variable
+ *  @param   value       Value of the variable
+ */
+
+    void setConstVar (unsigned slot, NUM_TYPE value);
+
+//------------------------------------------------------------------------------
+/*! @brief   Get state of the program.
+ *
+ *  @return  CALC_OK or error code of the compilation
+ */
+
+    int getErrCode ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Get slot of the variable, adds it if it is not present yet.
+ *
+ *  @param   varname     Variable name
+ *  @param   symbol      Symbol of the variable name
+ *
+ *  @return  slot of the variable
+ */
+
+    unsigned findVar (char* varname, uint32_t symbol);
+
+/*------------------------------------------------------------------------------
+                   Private functions                                           *
+*///----------------------------------------------------------------------------
+
+private:
+
+//------------------------------------------------------------------------------
+/*! @brief   Run the program on double if all constants and variables are real.
+ *
+ *  @param   vars        Values of variables in order of vars_
+ *  @param   number      Result of the expression
+ *
+ *  @return  true if the result stayed finite and real, else false
+ */
+
+    bool ExecuteReal (const NUM_TYPE* vars, NUM_TYPE& number);
+
+//------------------------------------------------------------------------------
+/*! @brief   Run the program over one block of rows on double.
+ *
+ *  @param   columns     Columns of variable values in order of vars_
+ *  @param   output      Array for results
+ *  @param   begin       First row of the block
+ *  @param   rows_num    Number of rows in the block (not more than BATCH_BLOCK)
+ *  @param   scratch     Registers memory, regs_num_ * BATCH_BLOCK doubles
+ *
+ *  @return  true if all results stayed finite and real, else false
+ */
+
+    bool ExecuteBlockReal (const NUM_TYPE* const* columns, NUM_TYPE* output, size_t begin, size_t rows_num, double* scratch);
+
+//------------------------------------------------------------------------------
+/*! @brief   Emit instructions of the subtree in postfix order by the prev_ walk,
+ *           structurally equal subtrees share one instruction.
+ *
+ *  @param   root        Root of the subtree
+ *  @param   value       Number of the instruction computing the root
+ *
+ *  @return  error code
+ */
+
+    int Compile (Node<CalcNodeData>* root, unsigned& value);
+
+//------------------------------------------------------------------------------
+/*! @brief   Find the same instruction or append the new one.
+ *
+ *  @param   ins         Instruction with operands given by numbers of instructions
+ *
+ *  @return  number of the instruction
+ */
+
+    unsigned AddInstruction (Instruction ins);
+
+//------------------------------------------------------------------------------
+/*! @brief   Find the same constant or append the new one.
+ *
+ *  @param   number      Value of the constant
+ *
+ *  @return  index of the constant
+ */
+
+    unsigned AddConst (NUM_TYPE number);
+
+//------------------------------------------------------------------------------
+/*! @brief   Replace numbers of instructions with registers, reusing registers
+ *           of values after their last read.
+ *
+ *  @param   root        Number of the instruction computing the result
+ */
+
+    void Allocate (unsigned root);
+
+//------------------------------------------------------------------------------
+};
+
+//------------------------------------------------------------------------------
+/*! @brief   Count nodes of the subtree.
+ *
+ *  @param   root        Root of the subtree
+ *
+ *  @return  number of nodes
+ */
+
+size_t CountNodes (Node<CalcNodeData>* root);
+
+//------------------------------------------------------------------------------
+
+#endif // BYTECODE_H_INCLUDED
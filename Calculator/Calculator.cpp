@@ -9,17 +9,25 @@
     *///------------------------------------------------------------------------
 
 #include "Calculator.h"
+#include "Aot.h"
+#include "ExprFile.h"
+#include "FlatExpr.h"
 
 //------------------------------------------------------------------------------
 
 Calculator::Calculator () :
+    state_        (CALC_OK),
     filename_     (nullptr),
+    eval_mode_    (EVAL_BYTECODE),
+    threads_num_  (0),
+    real_mode_    (true),
+    stats_        (false),
     trees_        ((char*)"trees of expression"),
-    variables_    ((char*)"variables"),
-    state_        (CALC_OK)
+    variables_    ((char*)"variables")
 {
     Tree<CalcNodeData> tree((char*)"expression");
-    trees_.Push(tree);
+    trees_.Push(std::move(tree));
+    trees_[0].useArena();
 
     ADD_VAR(variables_);
 }
@@ -27,13 +35,19 @@ Calculator::Calculator () :
 //------------------------------------------------------------------------------
 
 Calculator::Calculator (char* filename) :
+    state_        (CALC_OK),
     filename_     (filename),
+    eval_mode_    (EVAL_BYTECODE),
+    threads_num_  (0),
+    real_mode_    (true),
+    stats_        (false),
     trees_        ((char*)"trees of expression"),
-    variables_    ((char*)"variables"),
-    state_        (CALC_OK)
+    variables_    ((char*)"variables")
 {
-    Tree<CalcNodeData> tree(GetTrueFileName(filename));
-    trees_.Push(tree);
+    /* GetTrueFileName cuts the extension in place, filename_ must stay whole */
+    Tree<CalcNodeData> tree((char*)"expression");
+    trees_.Push(std::move(tree));
+    trees_[0].useArena();
 
     ADD_VAR(variables_);
 }
@@ -45,7 +59,11 @@ Calculator::~Calculator ()
     CALC_ASSERTOK((this == nullptr),           CALC_NULL_INPUT_CALCULATOR_PTR);
     CALC_ASSERTOK((state_ == CALC_DESTRUCTED), CALC_DESTRUCTED               );
 
-    filename_ = nullptr;
+    delete [] var_leaves_;
+
+    filename_     = nullptr;
+    var_leaves_   = nullptr;
+    watched_root_ = nullptr;
 
     state_ = CALC_DESTRUCTED;
 }
@@ -64,7 +82,7 @@ int Calculator::Run ()
             printf("\nEnter expression: ");
 
             char* expr = ScanExpr();
-            Expression expression = { expr, expr, CALC_OK };
+            Expression expression = { expr, expr, CALC_OK, &variables_ };
 
             int err = Expr2Tree(expression, trees_[0]);
             delete [] expr;
@@ -72,20 +90,23 @@ int Calculator::Run ()
             {
                 //printExprGraph(trees_[0]);
 
-                err = Calculate(trees_[0].root_, true);
+                NUM_TYPE number = 0;
+                err = Evaluate(number);
                 if (err)
                     printf("%s\n", calc_errstr[err + 1]);
                 else
-                    Write();
+                    Write(number);
             }
             char* tree_name = trees_[0].name_;
 
 
             trees_.Clean();
             variables_.Clean();
+            watched_root_ = nullptr;
 
             Tree<CalcNodeData> tree(GetTrueFileName(tree_name));
-            trees_.Push(tree);
+            trees_.Push(std::move(tree));
+            trees_[0].useArena();
 
             ADD_VAR(variables_);
 
@@ -93,23 +114,36 @@ int Calculator::Run ()
             running = scanAns();
         }
     }
+    else if (save_file_ != nullptr)
+    {
+        return RunSave();
+    }
+    else if (load_file_)
+    {
+        return RunLoad();
+    }
+    else if (batch_output_ != nullptr)
+    {
+        return RunBatch();
+    }
     else
     {
         Text text(filename_);
         char* expr = text.text_;
-        Expression expression = { expr, expr, CALC_OK };
+        Expression expression = { expr, expr, CALC_OK, &variables_ };
 
+        /* text_ is owned and freed by the text */
         int err = Expr2Tree(expression, trees_[0]);
-        delete [] expr;
         if (err) return err;
 
         //printExprGraph(trees_[0]);
 
-        err = Calculate(trees_[0].root_, true);
+        NUM_TYPE number = 0;
+        err = Evaluate(number);
         if (err)
             printf("%s\n", calc_errstr[err + 1]);
         else
-            Write();
+            Write(number);
     }
     
     return CALC_OK;
@@ -117,133 +151,741 @@ int Calculator::Run ()
 
 //------------------------------------------------------------------------------
 
-int Calculator::Calculate (Node<CalcNodeData>* node_cur, bool with_new_var)
+int Calculator::RunBatch ()
 {
-    assert(node_cur != nullptr);
+    /* lines are split block by block, so the first block is calculated before the whole file is read */
+    Text text(filename_, TEXT_MAP);
+    if (text.text_ == nullptr) return CALC_NOT_OK;
 
-    NUM_TYPE number    = 0;
-    NUM_TYPE right_num = 0;
-    NUM_TYPE left_num  = 0;
+    FILE* output = fopen(batch_output_, "w");
+    if (output == nullptr) return CALC_NOT_OK;
 
-    switch (node_cur->getData().node_type)
+    char* results = new char[BATCH_BLOCK_LINES * BATCH_RESULT_LEN];
+
+    size_t lines_num = 0;
+    while ((lines_num = text.NextLines(BATCH_BLOCK_LINES)) > 0)
     {
-    case NODE_FUNCTION:
+        WriteBlock(output, results, lines_num, [&] (size_t i, char* result)
+        {
+            if (text.lines_[i].len == 0)
+            {
+                *result = '\0';
+                return;
+            }
+
+            NUM_TYPE number = 0;
+            int err = EvaluateLine(text.lines_[i].str, number);
+
+            Result2Str(err, number, result, BATCH_RESULT_LEN);
+        });
+    }
+
+    delete [] results;
+    fclose(output);
+
+    return CALC_OK;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename EVALUATE>
+void Calculator::WriteBlock (FILE* output, char* results, size_t num, EVALUATE evaluate)
+{
+    assert(output  != nullptr);
+    assert(results != nullptr);
+    assert(num <= BATCH_BLOCK_LINES);
+
+    int threads = (threads_num_ > 0) ? threads_num_ : omp_get_max_threads();
+
+    #pragma omp parallel for schedule(dynamic, 256) num_threads(threads)
+    for (size_t i = 0; i < num; ++i)
+        evaluate(i, results + i * BATCH_RESULT_LEN);
+
+    /* results of the block are written in the order of the lines */
+    for (size_t i = 0; i < num; ++i)
     {
-        assert((node_cur->right_ != nullptr) && (node_cur->left_ == nullptr));
-        int err = Calculate(node_cur->right_, with_new_var);
-        if (err) return err;
+        fputs(results + i * BATCH_RESULT_LEN, output);
+        fputc('\n', output);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+int Calculator::EvaluateLine (char* line, NUM_TYPE& number)
+{
+    assert(line != nullptr);
 
-        number = node_cur->right_->getData().number;
+    /* every thread reuses its arena, so short lines cost no allocations for nodes */
+    static thread_local NodeArena<CalcNodeData> arena;
 
-        #define ONE static_cast<NUM_TYPE>(1)
-        #define TWO static_cast<NUM_TYPE>(2)
+    Expression expr = { line, line };
+    expr.quiet = true;
+    expr.arena = &arena;
+
+    expr.token = { TOKEN_END, 0, 0 };
+    NextToken(expr);
+
+    Node<CalcNodeData>* root = pass_Expression(expr);
+    if (root == nullptr)
+    {
+        arena.Release();
+        return expr.err;
+    }
+
+    int err = Calculate(root, false);
+    if (!err) number = root->getData().number;
+
+    arena.Release();
+
+    return err;
+}
+
+//------------------------------------------------------------------------------
+
+int Calculator::RunSave ()
+{
+    Text text(filename_, TEXT_MAP);
+    if (text.text_ == nullptr) return CALC_NOT_OK;
 
-        switch (node_cur->getData().op_code)
+    ExprFileWriter writer;
+
+    Tree<CalcNodeData> tree((char*)"saved expression");
+    tree.useArena();
+
+    size_t line      = 0;
+    size_t lines_num = 0;
+    while ((lines_num = text.NextLines(BATCH_BLOCK_LINES)) > 0)
+    {
+        for (size_t i = 0; i < lines_num; ++i)
         {
-        case OP_ARCCOS:     number = acos(number);          break;
-        case OP_ARCCOSH:    number = acosh(number);         break;
-        case OP_ARCCOT:     number = PI/TWO - atan(number); break;
-        case OP_ARCCOTH:    number = atanh(ONE / number);   break;
-        case OP_ARCSIN:     number = asin(number);          break;
-        case OP_ARCSINH:    number = asinh(number);         break;
-        case OP_ARCTAN:     number = atan(number);          break;
-        case OP_ARCTANH:    number = atanh(number);         break;
-        case OP_COS:        number = cos(number);           break;
-        case OP_COSH:       number = cosh(number);          break;
-        case OP_COT:        number = ONE / tan(number);     break;
-        case OP_COTH:       number = ONE / tanh(number);    break;
-        case OP_EXP:        number = exp(number);           break;
-        case OP_LG:         number = log10(number);         break;
-        case OP_LN:         number = log(number);           break;
-        case OP_SIN:        number = sin(number);           break;
-        case OP_SINH:       number = sinh(number);          break;
-        case OP_SQRT:       number = sqrt(number);          break;
-        case OP_TAN:        number = tan(number);           break;
-        case OP_TANH:       number = tanh(number);          break;
-        default: assert(0);
+            ++line;
+            if (text.lines_[i].len == 0) continue;
+
+            /* slots are not saved, so the variables of the calculator are not used */
+            char* expr = text.lines_[i].str;
+            Expression expression = { expr, expr, CALC_OK };
+
+            int err = Expr2Tree(expression, tree);
+            if (err)
+            {
+                printf("Line %zu: %s\n", line, calc_errstr[expression.err + 1]);
+                return expression.err;
+            }
+
+            Program program(tree);
+
+            err = program.getErrCode();
+            if (err)
+            {
+                printf("Line %zu: %s\n", line, calc_errstr[err + 1]);
+                return err;
+            }
+
+            err = writer.Add(tree, &program);
+            if (err) return err;
+
+            tree.Clean();
         }
+    }
 
-        #undef ONE
-        #undef TWO
+    int err = writer.Write(save_file_);
+    if (err) printf("%s\n", calc_errstr[err + 1]);
 
-        node_cur->setData({ number, node_cur->getData().word, node_cur->getData().op_code, node_cur->getData().node_type });
-        break;
+    return err;
+}
+
+//------------------------------------------------------------------------------
+
+int Calculator::RunLoad ()
+{
+    /* the file is mapped and checked, nothing of it is parsed */
+    ExprFile file(filename_);
+
+    int err = file.getErrCode();
+    if (err)
+    {
+        printf("%s\n", calc_errstr[err + 1]);
+        return err;
     }
-    case NODE_OPERATOR:
+
+    if (batch_output_ == nullptr)
     {
-        if (node_cur->left_ != nullptr)
+        if (file.exprs_num_ == 0) return CALC_NOT_OK;
+
+        NUM_TYPE number = 0;
+
+        if ((eval_mode_ == EVAL_BYTECODE) && file.hasProgram(0))
         {
-            int err = Calculate(node_cur->left_, with_new_var);
-            if (err) return err;
+            Program program(file, 0);
+            program.real_mode_ = real_mode_;
 
-            left_num = node_cur->left_->getData().number;
+            err = Execute(program, nullptr, number);
+        }
+        else
+        {
+            file.getTree(0, trees_[0], &variables_);
+
+            err = Evaluate(number);
         }
-        else left_num = 0;
 
-        int err = Calculate(node_cur->right_, with_new_var);
+        /* Write would put the result over the compiled file, so it is printed */
+        if (err)
+            printf("%s\n", calc_errstr[err + 1]);
+        else
+        {
+            char* strnum = Num2Str(number);
+            printf("result: %s\n", strnum);
+            delete [] strnum;
+        }
+
+        return CALC_OK;
+    }
+
+    FILE* output = fopen(batch_output_, "w");
+    if (output == nullptr) return CALC_NOT_OK;
+
+    char* results = new char[BATCH_BLOCK_LINES * BATCH_RESULT_LEN];
+
+    for (size_t begin = 0; begin < file.exprs_num_; begin += BATCH_BLOCK_LINES)
+    {
+        size_t exprs_num = (file.exprs_num_ - begin < BATCH_BLOCK_LINES) ? file.exprs_num_ - begin : BATCH_BLOCK_LINES;
+
+        WriteBlock(output, results, exprs_num, [&] (size_t i, char* result)
+        {
+            NUM_TYPE number = 0;
+            int err = EvaluateLoaded(file, begin + i, number);
+
+            Result2Str(err, number, result, BATCH_RESULT_LEN);
+        });
+    }
+
+    delete [] results;
+    fclose(output);
+
+    return CALC_OK;
+}
+
+//------------------------------------------------------------------------------
+
+int Calculator::EvaluateLoaded (ExprFile& file, size_t index, NUM_TYPE& number)
+{
+    if ((eval_mode_ != EVAL_TREE) && file.hasProgram(index))
+    {
+        Program program(file, index);
+        program.real_mode_ = real_mode_;
+
+        int err = program.getErrCode();
         if (err) return err;
 
-        right_num = node_cur->right_->getData().number;
+        NUM_TYPE* values = new NUM_TYPE[program.vars_num_ + 1] {};
+
+        for (size_t i = 0; (i < program.vars_num_) && (err == CALC_OK); ++i)
+            err = getVariable(program.vars_[i], program.var_symbols_[i], program.var_slots_[i], false, values[i]);
+
+        if (!err) number = program.Execute(values);
+
+        delete [] values;
 
-        switch (node_cur->getData().op_code)
+        return err;
+    }
+
+    /* every thread reuses its tree, its arena keeps the nodes between expressions */
+    static thread_local Tree<CalcNodeData> tree((char*)"loaded expression");
+    tree.useArena();
+
+    file.getTree(index, tree);
+
+    int err = Calculate(tree.root_, false);
+    if (!err) number = tree.root_->getData().number;
+
+    tree.Clean();
+
+    return err;
+}
+
+//------------------------------------------------------------------------------
+
+int Calculator::Calculate (Node<CalcNodeData>* node_cur, bool with_new_var)
+{
+    assert(node_cur != nullptr);
+
+    /* children are calculated before parents by the prev_ walk, deep trees do not grow the call stack */
+    const Node<CalcNodeData>* root = node_cur;
+
+    for (node_cur = node_cur->firstPostorder(); node_cur != nullptr; node_cur = node_cur->nextPostorder(root))
+    {
+        CalcNodeData data = node_cur->getData();
+
+        switch (data.node_type)
+        {
+        case NODE_FUNCTION:
         {
-        case OP_ADD:  number = left_num + right_num;     break;
-        case OP_SUB:  number = left_num - right_num;     break;
-        case OP_MUL:  number = left_num * right_num;     break;
-        case OP_DIV:  number = left_num / right_num;     break;
-        case OP_POW:  number = pow(left_num, right_num); break;
+            assert((node_cur->right_ != nullptr) && (node_cur->left_ == nullptr));
+
+            data.number = calcFunction(data.op_code, node_cur->right_->getData().number);
+            break;
+        }
+        case NODE_OPERATOR:
+        {
+            NUM_TYPE left_num = 0;
+            if (node_cur->left_ != nullptr) left_num = node_cur->left_->getData().number;
+
+            data.number = calcOperator(data.op_code, left_num, node_cur->right_->getData().number);
+            break;
+        }
+        case NODE_VARIABLE:
+        {
+            assert((node_cur->right_ == nullptr) && (node_cur->left_ == nullptr));
+
+            int err = getVariable(data.word, data.symbol, data.slot, with_new_var, data.number);
+            if (err) return err;
+            break;
+        }
+        case NODE_NUMBER:
+            break;
+
         default: assert(0);
         }
 
-        node_cur->setData({ number, node_cur->getData().word, node_cur->getData().op_code, node_cur->getData().node_type });
-        break;
+        data.dirty = false;
+        node_cur->setData(data);
     }
-    case NODE_VARIABLE:
+
+    return CALC_OK;
+}
+
+//------------------------------------------------------------------------------
+
+int Calculator::getVariable (char* varname, uint32_t symbol, bool with_new_var, NUM_TYPE& number)
+{
+    assert(varname != nullptr);
+
+    int index = -1;
+    for (int i = 0; i < variables_.getSize(); ++i)
+        if (variables_[i].symbol == symbol)
+        {
+            index = i;
+            break;
+        }
+
+    if (index == -1)
     {
-        assert((node_cur->right_ == nullptr) && (node_cur->left_ == nullptr));
+        if (not with_new_var) return CALC_WRONG_VARIABLE;
 
-        int index = -1;
-        for (int i = 0; i < variables_.getSize(); ++i)
-            if (strcmp(variables_[i].name, node_cur->getData().word) == 0)
-            {
-                index = i;
-                break;
-            }
-        
-        if (index == -1)
+        index = findVariable(variables_, varname, symbol);
+    }
+
+    return getVariable(index, with_new_var, number);
+}
+
+//------------------------------------------------------------------------------
+
+int Calculator::getVariable (int slot, bool with_new_var, NUM_TYPE& number)
+{
+    assert((0 <= slot) && (slot < variables_.getSize()));
+
+    number = variables_[slot].value;
+
+    if (isPOISON(number) && not variables_[slot].scanned)
+    {
+        if (not with_new_var) return CALC_WRONG_VARIABLE;
+
+        /* the variable may be met again while its value is being calculated */
+        variables_[slot].scanned = true;
+
+        number = scanVar(*this, (char*)variables_[slot].name);
+        variables_[slot].value = number;
+    }
+
+    if (isPOISON(number))
+    {
+        return CALC_UNIDENTIFIED_VARIABLE;
+    }
+
+    return CALC_OK;
+}
+
+//------------------------------------------------------------------------------
+
+int Calculator::getVariable (char* varname, uint32_t symbol, int slot, bool with_new_var, NUM_TYPE& number)
+{
+    assert(varname != nullptr);
+
+    /* slot is valid only if the tree was parsed with this stack of variables */
+    if ((0 <= slot) && (slot < variables_.getSize()) && (variables_[slot].symbol == symbol))
+        return getVariable(slot, with_new_var, number);
+
+    return getVariable(varname, symbol, with_new_var, number);
+}
+
+//------------------------------------------------------------------------------
+
+int Calculator::setVariable (const char* varname, NUM_TYPE value)
+{
+    assert(varname != nullptr);
+
+    if (trees_[0].root_ != watched_root_) WatchTree();
+
+    uint32_t symbol = 0;
+    char*    name   = internName(varname, strlen(varname), symbol);
+
+    int index = -1;
+    for (int i = 0; i < variables_.getSize(); ++i)
+        if (variables_[i].symbol == symbol)
+        {
+            index = i;
+            break;
+        }
+
+    if ((index != -1) && (variables_[index].value == value)) return CALC_OK;
+
+    for (size_t i = 0; i < var_leaves_num_; ++i)
+    {
+        Node<CalcNodeData>* node_cur = var_leaves_[i];
+        if (node_cur->getData().symbol != symbol) continue;
+
+        /* ancestors of a dirty node are already dirty */
+        while ((node_cur != nullptr) && not node_cur->getData().dirty)
+        {
+            CalcNodeData data = node_cur->getData();
+            data.dirty = true;
+            node_cur->setData(data);
+
+            node_cur = node_cur->prev_;
+        }
+    }
+
+    if (index != -1)
+        variables_[index].value = value;
+    else
+        variables_.Push({ value, name, false, symbol });
+
+    return CALC_OK;
+}
+
+//------------------------------------------------------------------------------
+
+int Calculator::reevaluate ()
+{
+    CALC_ASSERTOK((trees_[0].root_ == nullptr), CALC_NOT_OK);
+
+    if (trees_[0].root_ != watched_root_) WatchTree();
+
+    return Recalculate(trees_[0].root_);
+}
+
+//------------------------------------------------------------------------------
+
+/* the lowest dirty node of the subtree, clean subtrees are not entered */
+static Node<CalcNodeData>* FirstDirty (Node<CalcNodeData>* node_cur)
+{
+    while (true)
+    {
+        if ((node_cur->left_ != nullptr) && node_cur->left_->getData().dirty)
+            node_cur = node_cur->left_;
+        else
+        if ((node_cur->right_ != nullptr) && node_cur->right_->getData().dirty)
+            node_cur = node_cur->right_;
+        else
+            return node_cur;
+    }
+}
+
+int Calculator::Recalculate (Node<CalcNodeData>* node_cur)
+{
+    assert(node_cur != nullptr);
+
+    if (not node_cur->getData().dirty) return CALC_OK;
+
+    const Node<CalcNodeData>* root = node_cur;
+    node_cur = FirstDirty(node_cur);
+
+    while (true)
+    {
+        CalcNodeData data = node_cur->getData();
+
+        switch (data.node_type)
+        {
+        case NODE_FUNCTION:
         {
-            if (not with_new_var) return CALC_WRONG_VARIABLE;
+            assert((node_cur->right_ != nullptr) && (node_cur->left_ == nullptr));
 
-            variables_.Push({ POISON<NUM_TYPE>, node_cur->getData().word });
-            size_t size = variables_.getSize();
+            data.number = calcFunction(data.op_code, node_cur->right_->getData().number);
+            break;
+        }
+        case NODE_OPERATOR:
+        {
+            NUM_TYPE left_num = 0;
+            if (node_cur->left_ != nullptr) left_num = node_cur->left_->getData().number;
 
-            number = scanVar(*this, node_cur->getData().word);
-            variables_[size - 1] = { number, node_cur->getData().word };
+            data.number = calcOperator(data.op_code, left_num, node_cur->right_->getData().number);
+            break;
         }
-        else number = variables_[index].value;
-        
-        if (isPOISON(number))
+        case NODE_VARIABLE:
         {
-            return CALC_UNIDENTIFIED_VARIABLE;
+            int err = getVariable(data.word, data.symbol, data.slot, false, data.number);
+            if (err) return err;
+            break;
         }
+        case NODE_NUMBER:
+            break;
 
-        node_cur->setData({ number, node_cur->getData().word, node_cur->getData().op_code, node_cur->getData().node_type });
-        break;
+        default: assert(0);
+        }
+
+        data.dirty = false;
+        node_cur->setData(data);
+
+        if (node_cur == root) return CALC_OK;
+
+        /* parents of dirty nodes are dirty, so the walk goes up to the root */
+        Node<CalcNodeData>* prev = node_cur->prev_;
+        if ((node_cur == prev->left_) && (prev->right_ != nullptr) && prev->right_->getData().dirty)
+            node_cur = FirstDirty(prev->right_);
+        else
+            node_cur = prev;
     }
-    case NODE_NUMBER:
-        break;
+}
 
-    default: assert(0);
+//------------------------------------------------------------------------------
+
+static size_t CollectLeaves (Node<CalcNodeData>* root, Node<CalcNodeData>** leaves)
+{
+    if (root == nullptr) return 0;
+
+    size_t leaves_num = 0;
+    for (Node<CalcNodeData>* node_cur = root->firstPostorder(); node_cur != nullptr; node_cur = node_cur->nextPostorder(root))
+    {
+        if (node_cur->getData().node_type != NODE_VARIABLE) continue;
+
+        if (leaves != nullptr) leaves[leaves_num] = node_cur;
+        ++leaves_num;
     }
 
+    return leaves_num;
+}
+
+void Calculator::WatchTree ()
+{
+    delete [] var_leaves_;
+
+    watched_root_   = trees_[0].root_;
+    var_leaves_num_ = CollectLeaves(watched_root_, nullptr);
+    var_leaves_     = new Node<CalcNodeData>* [var_leaves_num_ + 1] {};
+
+    CollectLeaves(watched_root_, var_leaves_);
+}
+
+//------------------------------------------------------------------------------
+
+void Calculator::setEvalMode (int eval_mode)
+{
+    assert((eval_mode == EVAL_TREE) || (eval_mode == EVAL_FLAT) || (eval_mode == EVAL_BYTECODE) ||
+           (eval_mode == EVAL_JIT)  || (eval_mode == EVAL_AOT));
+
+    eval_mode_ = eval_mode;
+}
+
+//------------------------------------------------------------------------------
+
+void Calculator::setThreadsNum (int threads_num)
+{
+    assert(threads_num >= 0);
+
+    threads_num_ = threads_num;
+}
+
+//------------------------------------------------------------------------------
+
+void Calculator::setRealMode (bool real_mode)
+{
+    real_mode_ = real_mode;
+}
+
+//------------------------------------------------------------------------------
+
+void Calculator::setBatchOutput (char* outname)
+{
+    CALC_ASSERTOK((this == nullptr), CALC_NULL_INPUT_CALCULATOR_PTR);
+
+    batch_output_ = outname;
+}
+
+//------------------------------------------------------------------------------
+
+void Calculator::setSaveFile (char* filename)
+{
+    CALC_ASSERTOK((this == nullptr), CALC_NULL_INPUT_CALCULATOR_PTR);
+
+    save_file_ = filename;
+}
+
+//------------------------------------------------------------------------------
+
+void Calculator::setLoadFile (bool load)
+{
+    CALC_ASSERTOK((this == nullptr), CALC_NULL_INPUT_CALCULATOR_PTR);
+
+    load_file_ = load;
+}
+
+//------------------------------------------------------------------------------
+
+void Calculator::setStats (bool stats)
+{
+    stats_ = stats;
+}
+
+//------------------------------------------------------------------------------
+
+int Calculator::Evaluate (NUM_TYPE& number)
+{
+    if (eval_mode_ == EVAL_TREE)
+    {
+        int err = Calculate(trees_[0].root_, true);
+        if (err) return err;
+
+        number = trees_[0].root_->getData().number;
+
+        return CALC_OK;
+    }
+
+    if (eval_mode_ == EVAL_FLAT)
+    {
+        FlatExpr flat(trees_[0]);
+
+        if (stats_)
+            printf("nodes: %zu, bytes per node: %.1f\n", flat.tree_.size_, (double)flat.getBytes() / flat.tree_.size_);
+
+        NUM_TYPE* values = new NUM_TYPE[flat.vars_num_ + 1] {};
+
+        for (size_t i = 0; i < flat.vars_num_; ++i)
+        {
+            int err = getVariable(flat.vars_[i], flat.var_symbols_[i], flat.var_slots_[i], true, values[i]);
+            if (err)
+            {
+                delete [] values;
+                return err;
+            }
+        }
+
+        number = flat.Execute(values);
+
+        delete [] values;
+
+        return CALC_OK;
+    }
+
+    if (eval_mode_ == EVAL_JIT)
+    {
+        Jit jit(trees_[0]);
+        jit.program_.real_mode_ = real_mode_;
+
+        return Execute(jit.program_, jit.func_, number);
+    }
+
+    if (eval_mode_ == EVAL_AOT)
+    {
+        Aot aot(trees_[0]);
+        aot.program_.real_mode_ = real_mode_;
+
+        return Execute(aot.program_, aot.func_, number);
+    }
+
+    Program program(trees_[0]);
+    program.real_mode_ = real_mode_;
+
+    return Execute(program, nullptr, number);
+}
+
+//------------------------------------------------------------------------------
+
+int Calculator::Execute (Program& program, JitFunc func, NUM_TYPE& number)
+{
+    int err = program.getErrCode();
+    if (err) return err;
+
+    if (stats_)
+        printf("nodes: %zu, after CSE: %zu\n", program.nodes_num_, program.size_);
+
+    NUM_TYPE* values = new NUM_TYPE[program.vars_num_ + 1] {};
+
+    for (size_t i = 0; i < program.vars_num_; ++i)
+    {
+        err = getVariable(program.vars_[i], program.var_symbols_[i], program.var_slots_[i], true, values[i]);
+        if (err)
+        {
+            delete [] values;
+            return err;
+        }
+    }
+
+    number = (func != nullptr) ? func(values) : program.Execute(values);
+
+    delete [] values;
+
     return CALC_OK;
 }
 
 //------------------------------------------------------------------------------
 
-void Calculator::Write ()
+int Calculator::EvaluateBatch (Tree<CalcNodeData>& tree, const char* const* names, const NUM_TYPE* const* columns,
+                               size_t columns_num, NUM_TYPE* output, size_t rows_num)
 {
-    char* strnum = Num2Str(trees_[0].root_->getData().number);
+    assert((names   != nullptr) || (columns_num == 0));
+    assert((columns != nullptr) || (columns_num == 0));
+    assert(output   != nullptr);
+
+    Program program(tree);
+    program.real_mode_ = real_mode_;
+
+    int err = program.getErrCode();
+    if (err) return err;
+
+    const NUM_TYPE** var_columns = new const NUM_TYPE* [program.vars_num_ + 1] {};
+    uint32_t*        symbols     = new uint32_t         [columns_num + 1]        {};
+
+    for (size_t i = 0; i < columns_num; ++i)
+        internName(names[i], strlen(names[i]), symbols[i]);
+
+    for (size_t slot = 0; slot < program.vars_num_; ++slot)
+    {
+        for (size_t i = 0; i < columns_num; ++i)
+            if (symbols[i] == program.var_symbols_[slot])
+            {
+                var_columns[slot] = columns[i];
+                break;
+            }
+
+        if (var_columns[slot] == nullptr)
+        {
+            NUM_TYPE number = 0;
+            err = getVariable(program.vars_[slot], program.var_symbols_[slot], program.var_slots_[slot], false, number);
+            if (err)
+            {
+                delete [] var_columns;
+                delete [] symbols;
+                return err;
+            }
+
+            program.setConstVar(slot, number);
+        }
+    }
+
+    delete [] symbols;
+
+    program.ExecuteBatch(var_columns, output, rows_num, threads_num_);
+
+    delete [] var_columns;
+
+    return CALC_OK;
+}
+
+//------------------------------------------------------------------------------
+
+void Calculator::Write (NUM_TYPE number)
+{
+    char* strnum = Num2Str(number);
     if (filename_ == nullptr)
     {
         printf("result: %s\n", strnum);
@@ -376,7 +1018,7 @@ NUM_TYPE scanVar (Calculator& calc, char* varname)
     printf("Enter value of variable %s: ", varname);
 
     char* expr = ScanExpr();
-    Expression expression = { expr, expr, CALC_OK };
+    Expression expression = { expr, expr, CALC_OK, &calc.variables_ };
 
     Tree<CalcNodeData> vartree(varname);
     while (Expr2Tree(expression, vartree))
@@ -384,13 +1026,13 @@ NUM_TYPE scanVar (Calculator& calc, char* varname)
         delete [] expr;
         printf("Try again: ");
         expr = ScanExpr();
-        Expression expression = { expr, expr, CALC_OK };
+        expression = { expr, expr, CALC_OK, &calc.variables_ };
     }
     delete [] expr;
 
     //printExprGraph(vartree);
 
-    calc.trees_.Push(vartree);
+    calc.trees_.Push(std::move(vartree));
     size_t trees_size = calc.trees_.getSize();
     int err = calc.Calculate(calc.trees_[trees_size - 1].root_, true);
     if (err == CALC_UNIDENTIFIED_VARIABLE)
@@ -403,68 +1045,85 @@ NUM_TYPE scanVar (Calculator& calc, char* varname)
 
 char* Num2Str (NUM_TYPE number)
 {
-    char* str = new char[64] {};
+    char* str = new char[NUM_STR_LEN] {};
+    Num2Str(number, str, NUM_STR_LEN);
 
-    if (isnan(real(number)) || isnan(imag(number)))
+    return str;
+}
+
+//------------------------------------------------------------------------------
+
+static void Part2Str (double part, char* word, size_t size)
+{
+    /* %lf of a large value has hundreds of digits, such values go in exponent notation */
+    if (not (abs(part) < NUM_FIXED_MAX))
     {
-        sprintf(str, "Not a number (Nan)");
-        return str;
+        snprintf(word, size, "%.*g", DBL_DIG, part);
+        return;
     }
 
-    char* word = new char[64] {};
-    char* begin = str;
+    snprintf(word, size, "%lf", part);
 
-    bool was_real = 0;
-    if (abs(real(number)) > NIL)
+    /* only parts in the range of int are taken as whole, as before */
+    if ((INT_MIN <= part) && (part <= INT_MAX) && (abs(part - (int)part) <= NIL))
     {
-        sprintf(word, "%lf", real(number));
+        char* s = strchr(word, '.');
+        if (s != nullptr) *s = '\0';
+    }
+}
 
-        if (abs(real(number) - (int)real(number)) <= NIL)
-        {
-            char* s = strchr(word, '.');
-            if (s != nullptr) *s = '\0';
-        }
+//------------------------------------------------------------------------------
 
-        sprintf(str, "%s", word);
-        str += strlen(word);
-        was_real = 1;
-    }
+void Num2Str (NUM_TYPE number, char* str, size_t size)
+{
+    assert(str != nullptr);
+    assert(size > 0);
 
-    bool was_imag = 0;
-    if (abs(imag(number)) > NIL)
+    if (isnan(real(number)) || isnan(imag(number)))
     {
-        sprintf(word, "%lf", imag(number));
+        snprintf(str, size, "Not a number (Nan)");
+        return;
+    }
 
-        if (abs(imag(number) - (int)imag(number)) <= NIL)
-        {
-            char* s = strchr(word, '.');
-            if (s != nullptr) *s = '\0';
-        }
+    char real_word[NUM_STR_LEN] = "";
+    char imag_word[NUM_STR_LEN] = "";
+
+    bool was_real = (abs(real(number)) > NIL);
+    bool was_imag = (abs(imag(number)) > NIL);
 
-        if (was_real && (imag(number) > NIL))
-            sprintf(str++, "+");
+    if (was_real) Part2Str(real(number), real_word, sizeof(real_word));
 
+    if (was_imag)
+    {
         if ( (abs(imag(number) - static_cast<NUM_TYPE>(1)) <= NIL) ||
-             (abs(imag(number) + static_cast<NUM_TYPE>(1)) <= NIL) )
-        {
-            sprintf(str, "i");
-        }
+             (abs(imag(number) + static_cast<NUM_TYPE>(1)) <= NIL) )
+            imag_word[0] = '\0';
         else
-        {
-            sprintf(str, "%s", word);
-            str += strlen(word);
-            sprintf(str, "i");
-        }
-        
-        was_imag = 1;
+            Part2Str(imag(number), imag_word, sizeof(imag_word));
     }
 
-    if (not was_real && not was_imag)
-        sprintf(str, "0");
+    if (was_real && was_imag)
+        snprintf(str, size, "%s%s%si", real_word, (imag(number) > NIL) ? "+" : "", imag_word);
+    else
+    if (was_real)
+        snprintf(str, size, "%s", real_word);
+    else
+    if (was_imag)
+        snprintf(str, size, "%si", imag_word);
+    else
+        snprintf(str, size, "0");
+}
+
+//------------------------------------------------------------------------------
 
-    delete [] word;
+void Result2Str (int err, NUM_TYPE number, char* str, size_t size)
+{
+    assert(str != nullptr);
 
-    return begin;
+    if (err)
+        snprintf(str, size, "ERROR %d: %s", err, calc_errstr[err + 1]);
+    else
+        Num2Str(number, str, size);
 }
 
 //------------------------------------------------------------------------------
@@ -602,14 +1261,18 @@ int Node2Str (Node<CalcNodeData>* node_cur, char** str)
 
 int Expr2Tree (Expression& expr, Tree<CalcNodeData>& tree)
 {
-    assert(expr.str != nullptr);
+    assert(expr.str      != nullptr);
+    assert(expr.symb_cur != nullptr);
 
-    del_spaces(expr.str);
+    expr.arena = tree.getArena();
 
-    tree.root_ = pass_Plus_Minus(expr);
+    expr.token = { TOKEN_END, (unsigned)(expr.symb_cur - expr.str), 0 };
+    NextToken(expr);
+
+    tree.root_ = pass_Expression(expr);
     if (tree.root_ == nullptr) return CALC_NOT_OK;
 
-    tree.root_->recountPrev();
+    tree.root_->prev_ = nullptr;
     tree.root_->recountDepth();
 
     return CALC_OK;
@@ -617,198 +1280,286 @@ int Expr2Tree (Expression& expr, Tree<CalcNodeData>& tree)
 
 //------------------------------------------------------------------------------
 
-Node<CalcNodeData>* pass_Plus_Minus (Expression& expr)
+void NextToken (Expression& expr)
 {
-    Node<CalcNodeData>* node_cur = nullptr;
+    char* symb_cur = expr.str + expr.token.offset + expr.token.length;
 
-    if (*expr.symb_cur == '-')
-    {   
-        ++expr.symb_cur;
+    while (isspace(*symb_cur)) ++symb_cur;
 
-        Node<CalcNodeData>* right = pass_Mul_Div(expr);
-        if (right == nullptr) return nullptr;
+    expr.symb_cur = symb_cur;
+    Token token = { TOKEN_ERROR, (unsigned)(symb_cur - expr.str), 1 };
 
-        node_cur = new Node<CalcNodeData>;
-        node_cur->setData({ POISON<NUM_TYPE>, op_names[OP_SUB].word, op_names[OP_SUB].code, NODE_OPERATOR });
-        node_cur->right_ = right;
-    }
-    else
-    {
-        node_cur = pass_Mul_Div(expr);
-        if (node_cur == nullptr) return nullptr;
-    }
-    
-    while ( (*expr.symb_cur == '+') ||
-            (*expr.symb_cur == '-')   )
+    switch (*symb_cur)
     {
-        char* symb_cur = expr.symb_cur;
-        ++expr.symb_cur;
+    case '\0':
+        token.kind   = TOKEN_END;
+        token.length = 0;
+        break;
 
-        Node<CalcNodeData>* left  = node_cur;
-        Node<CalcNodeData>* right = pass_Mul_Div(expr);
-        if (right == nullptr) return nullptr;
+    case '+': case '-': case '*': case '/': case '^': case '(': case ')':
+        token.kind = *symb_cur;
+        break;
 
-        node_cur = new Node<CalcNodeData>;
-        char op = (*symb_cur == '-') ? OP_SUB : OP_ADD;
-        node_cur->setData({ POISON<NUM_TYPE>, op_names[op].word, op_names[op].code, NODE_OPERATOR });
+    default:
+        if (isdigit(*symb_cur))
+        {
+            char* end = symb_cur;
+            expr.number = strtod(symb_cur, &end);
+            if (*end == 'i') ++end;
 
-        node_cur->right_ = right;
-        node_cur->left_  = left;
-    }
+            token.kind   = TOKEN_NUMBER;
+            token.length = end - symb_cur;
+        }
+        else
+        if (isalpha(*symb_cur))
+        {
+            char* end = symb_cur;
+            while (isalpha(*end) || isdigit(*end)) ++end;
 
-    CHECK_SYNTAX(( (*expr.symb_cur != '+') &&
-                   (*expr.symb_cur != '-') &&
-                   (*expr.symb_cur != '*') &&
-                   (*expr.symb_cur != '/') &&
-                   (*expr.symb_cur != '^') &&
-                   (*expr.symb_cur != '(') &&
-                   (*expr.symb_cur != ')') &&
-                   (*expr.symb_cur != '\0') ), CALC_SYNTAX_ERROR, expr, 1);
+            token.kind   = TOKEN_NAME;
+            token.length = end - symb_cur;
+        }
+        break;
+    }
 
-    return node_cur;
+    expr.token = token;
 }
 
 //------------------------------------------------------------------------------
 
-Node<CalcNodeData>* pass_Mul_Div (Expression& expr)
+enum ParsePriorities
+{
+    PRIORITY_BRACKET = 0,
+    PRIORITY_ADD_SUB = 1,
+    PRIORITY_NEG     = 2,
+    PRIORITY_MUL_DIV = 3,
+    PRIORITY_POW     = 4,
+};
+
+struct PendingOp
 {
-    Node<CalcNodeData>* node_cur = pass_Power(expr);
-    if (node_cur == nullptr) return nullptr;
+    char op_code  = 0; /* function code or 0 for the open bracket */
+    char priority = PRIORITY_BRACKET;
+};
 
-    while ( (*expr.symb_cur == '*') ||
-            (*expr.symb_cur == '/') )
-    {
-        char* symb_cur = expr.symb_cur;
-        ++expr.symb_cur;
+/* the first values of the parser stacks are kept in the stack objects */
+const size_t PARSE_STACK_INLINE = 32;
 
-        Node<CalcNodeData>* left  = node_cur;
-        Node<CalcNodeData>* right = pass_Power(expr);
-        if (right == nullptr) return nullptr;
+template<> const char* const             PRINT_TYPE  <Node<CalcNodeData>*> = "Node<CalcNodeData>*";
+template<> const char* const             PRINT_FORMAT<Node<CalcNodeData>*> = "%p";
+template<> constexpr Node<CalcNodeData>* POISON      <Node<CalcNodeData>*> = nullptr;
 
-        node_cur = new Node<CalcNodeData>;
-        char op = (*symb_cur == '*') ? OP_MUL : OP_DIV;
-        node_cur->setData({ POISON<NUM_TYPE>, op_names[op].word, op_names[op].code, NODE_OPERATOR });
+template<> const char* const   PRINT_TYPE<PendingOp> = "PendingOp";
+template<> constexpr PendingOp POISON    <PendingOp> = { 0, -1 };
 
-        node_cur->right_ = right;
-        node_cur->left_  = left;
-    }
+bool isPOISON (PendingOp op)
+{
+    return op.priority == POISON<PendingOp>.priority;
+}
 
-    return node_cur;
+void TypePrint (FILE* fp, const PendingOp& op)
+{
+    fprintf(fp, "{ %d, %d }", op.op_code, op.priority);
 }
 
+typedef Stack<Node<CalcNodeData>*, PARSE_STACK_INLINE> ParseNodes;
+typedef Stack<PendingOp,           PARSE_STACK_INLINE> ParseOps;
+
 //------------------------------------------------------------------------------
 
-Node<CalcNodeData>* pass_Power (Expression& expr)
+static Node<CalcNodeData>* NewNode (Expression& expr)
 {
-    Node<CalcNodeData>* node_cur = pass_Brackets(expr);
-    if (node_cur == nullptr) return nullptr;
+    if (expr.arena != nullptr) return expr.arena->New();
 
-    while (*expr.symb_cur == '^')
-    {
-        ++expr.symb_cur;
+    return new Node<CalcNodeData>;
+}
+
+//------------------------------------------------------------------------------
 
-        Node<CalcNodeData>* left  = node_cur;
-        Node<CalcNodeData>* right = pass_Power(expr);
-        if (right == nullptr) return nullptr;
+static void ReduceOperator (Expression& expr, ParseNodes& nodes, PendingOp op)
+{
+    Node<CalcNodeData>* node_cur = NewNode(expr);
+    node_cur->setData({ POISON<NUM_TYPE>, op_names[op.op_code].word, op_names[op.op_code].code,
+                        (op.priority == PRIORITY_BRACKET) ? NODE_FUNCTION : NODE_OPERATOR });
 
-        node_cur = new Node<CalcNodeData>;
-        node_cur->setData({ POISON<NUM_TYPE>, op_names[OP_POW].word, op_names[OP_POW].code, NODE_OPERATOR });
+    node_cur->right_ = nodes.Pop();
+    node_cur->right_->prev_ = node_cur;
 
-        node_cur->right_ = right;
-        node_cur->left_  = left;
+    if ((op.priority != PRIORITY_BRACKET) && (op.priority != PRIORITY_NEG))
+    {
+        node_cur->left_ = nodes.Pop();
+        node_cur->left_->prev_ = node_cur;
     }
-    
-    return node_cur;
+
+    nodes.Push(node_cur);
 }
 
 //------------------------------------------------------------------------------
 
-Node<CalcNodeData>* pass_Brackets (Expression& expr)
+static Node<CalcNodeData>* ParseExpression (Expression& expr, ParseNodes& nodes, ParseOps& ops)
 {
-    if (*expr.symb_cur == '(')
+    bool operand    = true;
+    bool expr_start = true;
+
+    while (true)
     {
-        ++expr.symb_cur;
+        if (operand)
+        {
+            if ((expr.token.kind == '-') && expr_start)
+            {
+                ops.Push({ OP_SUB, PRIORITY_NEG });
+                NextToken(expr);
 
-        Node<CalcNodeData>* node_cur = pass_Plus_Minus(expr);
-        if (node_cur == nullptr) return nullptr;
+                expr_start = false;
+            }
+            else
+            if (expr.token.kind == '(')
+            {
+                ops.Push({ 0, PRIORITY_BRACKET });
+                NextToken(expr);
 
-        CHECK_SYNTAX((*expr.symb_cur != ')'), CALC_SYNTAX_NO_CLOSE_BRACKET, expr, 1);
-        ++expr.symb_cur;
+                expr_start = true;
+            }
+            else
+            if (expr.token.kind == TOKEN_NUMBER)
+            {
+                Node<CalcNodeData>* node_cur = pass_Number(expr);
+                if (node_cur == nullptr) return nullptr;
 
-        return node_cur;
-    }
+                nodes.Push(node_cur);
+                operand = false;
+            }
+            else
+            {
+                CHECK_SYNTAX((expr.token.kind != TOKEN_NAME), CALC_SYNTAX_ERROR, expr, 1);
 
-    else return pass_Function(expr);
-}
+                Token       name = expr.token;
+                const char* word = expr.str + name.offset;
 
-//------------------------------------------------------------------------------
+                NextToken(expr);
 
-Node<CalcNodeData>* pass_Function (Expression& expr)
-{
-    if (isdigit(*expr.symb_cur)) return pass_Number(expr);
+                if (expr.token.kind == '(')
+                {
+                    int code = findFunc(word, name.length);
 
-    else
-    {
-        CHECK_SYNTAX((not isalpha(*expr.symb_cur)), CALC_SYNTAX_ERROR, expr, 1);
+                    char* symb_cur = expr.symb_cur;
+                    expr.symb_cur = expr.str + name.offset;
+                    CHECK_SYNTAX((code == 0), CALC_SYNTAX_UNIDENTIFIED_FUNCTION, expr, name.length);
+                    expr.symb_cur = symb_cur;
 
-        char* word = new char [MAX_STR_LEN] {};
-        size_t index = 0;
+                    ops.Push({ (char)code, PRIORITY_BRACKET });
+                    NextToken(expr);
 
-        while (isalpha(*expr.symb_cur) || isdigit(*expr.symb_cur))
-        {
-            word[index++] = *expr.symb_cur;
+                    expr_start = true;
+                }
+                else
+                {
+                    uint32_t symbol  = 0;
+                    char*    varname = internName(word, name.length, symbol);
+                    int      slot    = (expr.variables != nullptr) ? findVariable(*expr.variables, varname, symbol) : -1;
+
+                    Node<CalcNodeData>* node_cur = NewNode(expr);
+                    node_cur->setData({ POISON<NUM_TYPE>, varname, 0, NODE_VARIABLE, true, slot, symbol });
+
+                    nodes.Push(node_cur);
+                    operand = false;
+                }
+            }
 
-            ++expr.symb_cur;
+            continue;
         }
 
-        word[index] = '\0';
+        PendingOp op = {};
 
-        if (*expr.symb_cur == '(')
+        switch (expr.token.kind)
+        {
+        case '+': op = { OP_ADD, PRIORITY_ADD_SUB }; break;
+        case '-': op = { OP_SUB, PRIORITY_ADD_SUB }; break;
+        case '*': op = { OP_MUL, PRIORITY_MUL_DIV }; break;
+        case '/': op = { OP_DIV, PRIORITY_MUL_DIV }; break;
+        case '^': op = { OP_POW, PRIORITY_POW     }; break;
+
+        case '(':
+        case ')':
+        case TOKEN_END:
         {
-            int code = findFunc(word);
-            delete [] word;
+            while ((ops.getSize() > 0) && (ops[ops.getSize() - 1].priority != PRIORITY_BRACKET))
+                ReduceOperator(expr, nodes, ops.Pop());
+
+            /* as before, the rest after the complete expression is not parsed */
+            if (ops.getSize() == 0)
+            {
+                Node<CalcNodeData>* root = nodes.Pop();
+                assert(nodes.getSize() == 0);
 
-            expr = { expr.str, expr.symb_cur - index };
-            CHECK_SYNTAX((code == 0), CALC_SYNTAX_UNIDENTIFIED_FUNCTION, expr, index);
-            expr = { expr.str, expr.symb_cur + index };
+                return root;
+            }
 
-            Node<CalcNodeData>* arg = pass_Brackets(expr);
-            if (arg == nullptr) return nullptr;
+            CHECK_SYNTAX((expr.token.kind != ')'), CALC_SYNTAX_NO_CLOSE_BRACKET, expr, 1);
+            NextToken(expr);
 
-            Node<CalcNodeData>* node_cur = new Node<CalcNodeData>;
-            node_cur->setData({ POISON<NUM_TYPE>, op_names[code].word, op_names[code].code, NODE_FUNCTION });
-            node_cur->right_ = arg;
+            PendingOp bracket = ops.Pop();
+            if (bracket.op_code != 0) ReduceOperator(expr, nodes, bracket);
 
-            return node_cur;
+            continue;
         }
-        else
-        {
-            Node<CalcNodeData>* node_cur = new Node<CalcNodeData>;
-            node_cur->setData({ POISON<NUM_TYPE>, word, 0, NODE_VARIABLE });
 
-            return node_cur;
-        }   
+        /* spaces separate tokens, "2 3" is not read as 23 */
+        case TOKEN_NUMBER:
+        case TOKEN_NAME:
+            CHECK_SYNTAX(true, CALC_SYNTAX_NO_OPERATOR, expr, expr.token.length);
+            break;
+
+        default:
+            CHECK_SYNTAX(true, CALC_SYNTAX_ERROR, expr, 1);
+        }
+
+        /* power is right-associative, the others are left-associative */
+        while ( (ops.getSize() > 0) && (ops[ops.getSize() - 1].priority != PRIORITY_BRACKET) &&
+                ( (ops[ops.getSize() - 1].priority >  op.priority) ||
+                 ((ops[ops.getSize() - 1].priority == op.priority) && (op.priority != PRIORITY_POW)) ) )
+            ReduceOperator(expr, nodes, ops.Pop());
+
+        ops.Push(op);
+        NextToken(expr);
+
+        operand    = true;
+        expr_start = false;
     }
 }
 
 //------------------------------------------------------------------------------
 
+Node<CalcNodeData>* pass_Expression (Expression& expr)
+{
+    ParseNodes nodes((char*)"nodes");
+    ParseOps   ops  ((char*)"ops");
+
+    Node<CalcNodeData>* root = ParseExpression(expr, nodes, ops);
+
+    /* subtrees left after a syntax error */
+    while (nodes.getSize() > 0) Node<CalcNodeData>::Delete(nodes.Pop());
+
+    return root;
+}
+
+//------------------------------------------------------------------------------
+
 Node<CalcNodeData>* pass_Number (Expression& expr)
 {
-    double value = 0;
-    char* begin = expr.symb_cur;
+    CHECK_SYNTAX((expr.token.kind != TOKEN_NUMBER), CALC_SYNTAX_NUMBER_ERROR, expr, 1);
 
-    value = strtod(expr.symb_cur, &expr.symb_cur);
-    CHECK_SYNTAX((expr.symb_cur == begin), CALC_SYNTAX_NUMBER_ERROR, expr, 1);
+    double value = expr.number;
+    bool   imag  = (expr.str[expr.token.offset + expr.token.length - 1] == 'i');
 
-    Node<CalcNodeData>* node_cur = new Node<CalcNodeData>;
+    NextToken(expr);
 
-    if (*expr.symb_cur == 'i')
-    {
-        ++expr.symb_cur;
+    Node<CalcNodeData>* node_cur = NewNode(expr);
+
+    if (imag)
         node_cur->setData({ {0, value}, nullptr, 0, NODE_NUMBER });
-    }
-    else node_cur->setData({ {value, 0}, nullptr, 0, NODE_NUMBER });
+    else
+        node_cur->setData({ {value, 0}, nullptr, 0, NODE_NUMBER });
 
     return node_cur;
 }
@@ -832,196 +1583,272 @@ char findFunc (char* word)
 {
     assert(word != nullptr);
 
-    operation func_key = { 0, word };
+    return findFunc(word, strlen(word));
+}
+
+//------------------------------------------------------------------------------
+
+char findFunc (const char* word, size_t len)
+{
+    assert(word != nullptr);
+
+    if (len == 0) return 0;
 
-    operation* p_func_struct = (operation*)bsearch(&func_key, op_names, OP_NUM, sizeof(op_names[0]), CompareOP_Names);
+    size_t index = funcHash(word, len, func_table.seed);
 
-    if (p_func_struct != nullptr) return p_func_struct->code;
+    if ( (func_table.codes[index] != 0) &&
+         (strncmp(func_table.words[index], word, len) == 0) && (func_table.words[index][len] == '\0') )
+        return func_table.codes[index];
 
     return 0;
 }
 
 //------------------------------------------------------------------------------
 
-void Optimize (Tree<CalcNodeData>& tree)
+const size_t NAME_CHUNK_SIZE = 4096;
+
+struct NameEntry
+{
+    char*    name   = nullptr;
+    uint32_t symbol = 0;
+};
+
+struct NamePool
+{
+    NameEntry* table      = nullptr;
+    size_t     table_size = 0;
+    uint32_t   names_num  = 0;
+
+    char*      chunk      = nullptr;
+    size_t     chunk_left = 0;
+};
+
+static NamePool name_pool;
+
+static size_t nameHash (const char* word, size_t len)
+{
+    size_t hsh = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < len; ++i)
+        hsh = (hsh ^ (unsigned char)word[i]) * 0x100000001B3ull;
+
+    return hsh;
+}
+
+char* internName (const char* word, size_t len, uint32_t& symbol)
 {
-    bool running = true;
-    while (running)
+    assert(word != nullptr);
+
+    NameEntry entry = {};
+
+    #pragma omp critical (calc_name_pool)
     {
-        running = Optimize(tree, tree.root_);
+        NamePool& pool = name_pool;
+
+        if (2 * ((size_t)pool.names_num + 1) > pool.table_size)
+        {
+            size_t     new_size  = (pool.table_size == 0) ? 64 : 2 * pool.table_size;
+            NameEntry* new_table = new NameEntry [new_size] {};
+
+            for (size_t i = 0; i < pool.table_size; ++i)
+                if (pool.table[i].name != nullptr)
+                {
+                    size_t index = nameHash(pool.table[i].name, strlen(pool.table[i].name)) & (new_size - 1);
+                    while (new_table[index].name != nullptr) index = (index + 1) & (new_size - 1);
+
+                    new_table[index] = pool.table[i];
+                }
+
+            delete [] pool.table;
+            pool.table      = new_table;
+            pool.table_size = new_size;
+        }
+
+        size_t index = nameHash(word, len) & (pool.table_size - 1);
+        for (; pool.table[index].name != nullptr; index = (index + 1) & (pool.table_size - 1))
+            if ((strncmp(pool.table[index].name, word, len) == 0) && (pool.table[index].name[len] == '\0'))
+            {
+                entry = pool.table[index];
+                break;
+            }
+
+        if (entry.name == nullptr)
+        {
+            if (pool.chunk_left < len + 1)
+            {
+                pool.chunk_left = (len + 1 > NAME_CHUNK_SIZE) ? len + 1 : NAME_CHUNK_SIZE;
+                pool.chunk      = new char[pool.chunk_left] {};
+            }
+
+            entry.name = pool.chunk;
+            memcpy(entry.name, word, len);
+            entry.name[len] = '\0';
+
+            pool.chunk      += len + 1;
+            pool.chunk_left -= len + 1;
+
+            /* symbol 0 is left for no name */
+            entry.symbol = ++pool.names_num;
+
+            pool.table[index] = entry;
+        }
     }
+
+    symbol = entry.symbol;
+
+    return entry.name;
+}
+
+//------------------------------------------------------------------------------
+
+int findVariable (Stack<Variable, VARIABLES_INLINE>& variables, char* varname, uint32_t symbol)
+{
+    assert(varname != nullptr);
+
+    for (int i = 0; i < variables.getSize(); ++i)
+        if (variables[i].symbol == symbol)
+            return i;
+
+    variables.Push({ POISON<NUM_TYPE>, varname, false, symbol });
+
+    return variables.getSize() - 1;
+}
+
+//------------------------------------------------------------------------------
+
+void Optimize (Tree<CalcNodeData>& tree)
+{
+    assert(tree.root_ != nullptr);
+
+    Optimize(tree, tree.root_);
     tree.root_->recountDepth();
 }
 
 //------------------------------------------------------------------------------
 
-#define OPTIMIZE_ACTION(node_to_place)                   \
-        {                                                \
-            if (node_cur->prev_ == nullptr)              \
-                tree.root_ = node_to_place;              \
-            else                                         \
-            if (node_cur->prev_->left_ == node_cur)      \
-                node_cur->prev_->left_ = node_to_place;  \
-            else                                         \
-                node_cur->prev_->right_ = node_to_place; \
-                                                         \
-            node_to_place->prev_ = node_cur->prev_;      \
-            node_to_place = nullptr;                     \
-                                                         \
-            delete node_cur;                             \
-            return true;                                 \
-        } //
+static Node<CalcNodeData>* ReplaceNode (Tree<CalcNodeData>& tree, Node<CalcNodeData>* node_cur, Node<CalcNodeData>* node_new)
+{
+    assert(node_cur != nullptr);
+    assert(node_new != nullptr);
+
+    if (node_cur->prev_ == nullptr)
+        tree.root_ = node_new;
+    else
+    if (node_cur->prev_->left_ == node_cur)
+        node_cur->prev_->left_ = node_new;
+    else
+        node_cur->prev_->right_ = node_new;
+
+    /* detach the node to place, so it survives deleting of the old one */
+    if (node_cur->left_  == node_new) node_cur->left_  = nullptr;
+    if (node_cur->right_ == node_new) node_cur->right_ = nullptr;
+
+    node_new->prev_ = node_cur->prev_;
+
+    Node<CalcNodeData>::Delete(node_cur);
+
+    return node_new;
+}
+
+//------------------------------------------------------------------------------
+
+static Node<CalcNodeData>* FoldNumber (Tree<CalcNodeData>& tree, Node<CalcNodeData>* node_cur, NUM_TYPE number)
+{
+    /* non-finite results are left to be computed, they can not be printed back */
+    if (not isfinite(real(number)) || not isfinite(imag(number))) return node_cur;
+
+    Node<CalcNodeData>* newnode = tree.NewNode();
+    newnode->setData({ number, nullptr, 0, NODE_NUMBER });
+
+    return ReplaceNode(tree, node_cur, newnode);
+}
 
 //------------------------------------------------------------------------------
 
-#define CALCULATE_ACTION(node, operation)                           \
-        {                                                           \
-            NUM_TYPE number1 = node->left_ ->getData().number;      \
-            NUM_TYPE number2 = node->right_->getData().number;      \
-                                                                    \
-            Node<CalcNodeData>* newnode = new Node<CalcNodeData>;   \
-            number1 = number1 operation number2;                    \
-                                                                    \
-            newnode->setData({ number1, nullptr, 0, NODE_NUMBER }); \
-            OPTIMIZE_ACTION(newnode);                               \
-        } //
+static bool isNumber (Node<CalcNodeData>* node_cur, NUM_TYPE number)
+{
+    return (node_cur != nullptr) && (node_cur->getData().node_type == NODE_NUMBER) && (node_cur->getData().number == number);
+}
 
 //------------------------------------------------------------------------------
 
-bool Optimize (Tree<CalcNodeData>& tree, Node<CalcNodeData>* node_cur)
+/* fold one node, its children are already optimized */
+static Node<CalcNodeData>* OptimizeNode (Tree<CalcNodeData>& tree, Node<CalcNodeData>* node_cur)
 {
     assert(node_cur != nullptr);
 
-    int err = 0;
+    const CalcNodeData& data  = node_cur->getData();
+    Node<CalcNodeData>* left  = node_cur->left_;
+    Node<CalcNodeData>* right = node_cur->right_;
 
-    switch (node_cur->getData().node_type)
+    const NUM_TYPE ZERO = 0;
+    const NUM_TYPE ONE  = 1;
+
+    switch (data.node_type)
     {
     case NODE_FUNCTION:
 
-        return Optimize(tree, node_cur->right_);
+        if (right->getData().node_type == NODE_NUMBER)
+            return FoldNumber(tree, node_cur, calcFunction(data.op_code, right->getData().number));
         break;
 
     case NODE_OPERATOR:
 
-        switch (node_cur->getData().op_code)
+        if ( ((left == nullptr) || (left->getData().node_type == NODE_NUMBER)) &&
+             (right->getData().node_type == NODE_NUMBER) )
         {
-        case OP_ADD:
-        case OP_SUB:
+            NUM_TYPE left_num = (left == nullptr) ? ZERO : left->getData().number;
+            return FoldNumber(tree, node_cur, calcOperator(data.op_code, left_num, right->getData().number));
+        }
 
-            if (node_cur->left_ == nullptr)
-            {
-                if (abs(node_cur->right_->getData().number) <= NIL)
-                {
-                    OPTIMIZE_ACTION(node_cur->right_);
-                }
-                else return Optimize(tree, node_cur->right_);
-            }
-            else
-            if (abs(node_cur->left_->getData().number) <= NIL)
-            {
-                OPTIMIZE_ACTION(node_cur->right_);
-            }
-            else
-            if (abs(node_cur->right_->getData().number) <= NIL)
-            {
-                OPTIMIZE_ACTION(node_cur->left_);
-            }
-            else
-            if ( (node_cur->left_ ->getData().node_type == NODE_NUMBER) &&
-                 (node_cur->right_->getData().node_type == NODE_NUMBER)   )
-            {
-                if (node_cur->getData().op_code == OP_ADD)
-                {
-                    CALCULATE_ACTION(node_cur, +);
-                }
-                else
-                {
-                    CALCULATE_ACTION(node_cur, -);
-                }
-            }
-            else
-            {
-                if (Optimize(tree, node_cur->left_)) return true;
+        /* only identities exact for any value of the other operand, x * 0 is NaN for infinite x */
+        switch (data.op_code)
+        {
+        case OP_ADD:
+            if (isNumber(left,  ZERO)) return ReplaceNode(tree, node_cur, right);
+            if (isNumber(right, ZERO)) return ReplaceNode(tree, node_cur, left);
+            break;
 
-                return Optimize(tree, node_cur->right_);
-            }
+        case OP_SUB:
+            if (isNumber(right, ZERO) && (left != nullptr)) return ReplaceNode(tree, node_cur, left);
             break;
 
         case OP_MUL:
-
-            if (abs(node_cur->left_->getData().number) <= NIL)
-            {
-                OPTIMIZE_ACTION(node_cur->left_);
-            }
-            else
-            if (abs(node_cur->right_->getData().number) <= NIL)
-            {
-                OPTIMIZE_ACTION(node_cur->right_);
-            }
-            else
-            if (abs(node_cur->left_->getData().number - static_cast<NUM_TYPE>(1)) <= NIL)
-            {
-                OPTIMIZE_ACTION(node_cur->right_);
-            }
-            else
-            if (abs(node_cur->right_->getData().number - static_cast<NUM_TYPE>(1)) <= NIL)
-            {
-                OPTIMIZE_ACTION(node_cur->left_);
-            }
-            else
-            if ( (node_cur->left_ ->getData().node_type == NODE_NUMBER) &&
-                 (node_cur->right_->getData().node_type == NODE_NUMBER)   )
-            {
-                CALCULATE_ACTION(node_cur, *);
-            }
-            else
-            {
-                if (Optimize(tree, node_cur->left_)) return true;
-
-                return Optimize(tree, node_cur->right_);
-            }
+            if (isNumber(left,  ONE)) return ReplaceNode(tree, node_cur, right);
+            if (isNumber(right, ONE)) return ReplaceNode(tree, node_cur, left);
             break;
 
         case OP_DIV:
-
-            if (abs(node_cur->left_->getData().number) <= NIL)
-            {
-                OPTIMIZE_ACTION(node_cur->left_);
-            }
-            else
-            if (abs(node_cur->right_->getData().number - static_cast<NUM_TYPE>(1)) <= NIL)
-            {
-                OPTIMIZE_ACTION(node_cur->left_);
-            }
-            else
-            if ( (abs(node_cur->left_->getData().number - node_cur->right_->getData().number) <= NIL) &&
-                 ((node_cur->left_->getData().node_type == NODE_VARIABLE) || (node_cur->left_->getData().node_type == NODE_NUMBER)) )
-            {
-                Node<CalcNodeData>* newnode = new Node<CalcNodeData>;
-                newnode->setData({ {1, 0}, nullptr, 0, NODE_NUMBER });
-
-                OPTIMIZE_ACTION(newnode);
-            }
-            else
-            {
-                if (Optimize(tree, node_cur->left_)) return true;
-
-                return Optimize(tree, node_cur->right_);
-            }
+            if (isNumber(right, ONE)) return ReplaceNode(tree, node_cur, left);
             break;
         }
         break;
 
     case NODE_VARIABLE:
-        break;
-    
     case NODE_NUMBER:
         break;
 
     default: assert(0);
     }
 
-    return false;
+    return node_cur;
+}
+
+//------------------------------------------------------------------------------
+
+Node<CalcNodeData>* Optimize (Tree<CalcNodeData>& tree, Node<CalcNodeData>* node_cur)
+{
+    assert(node_cur != nullptr);
+
+    /* the replacing node takes the place and prev_ of the old one, so the walk goes on from it */
+    const Node<CalcNodeData>* root = node_cur;
+
+    for (node_cur = node_cur->firstPostorder(); ; node_cur = node_cur->nextPostorder(root))
+    {
+        bool is_root = (node_cur == root);
+
+        node_cur = OptimizeNode(tree, node_cur);
+        if (is_root) return node_cur;
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -31,6 +31,8 @@
 #include "../TreeLib/Tree.h"
 #include "Operations.h"
 #include <complex>
+#include <float.h>
+#include <limits.h>
 #include <math.h>
 #include <omp.h>
 
@@ -47,11 +49,29 @@ template<> constexpr NUM_TYPE POISON<NUM_TYPE> = {NAN, NAN};
 
 constexpr double NIL = 1e-9;
 
-#define ADD_VAR(variables)                \
-        {                                 \
-            variables.Push({ PI, "pi" }); \
-            variables.Push({ E,  "e"  }); \
-            variables.Push({ I,  "i"  }); \
+constexpr double NUM_FIXED_MAX = 1e15; // larger parts of numbers are written in exponent notation
+const size_t     NUM_STR_LEN   = 64;   // enough for any number written by Num2Str
+
+class Program;
+class ExprFile;
+
+enum EvalModes
+{
+    EVAL_TREE     = 0,
+    EVAL_BYTECODE = 1,
+    EVAL_JIT      = 2,
+    EVAL_AOT      = 3,
+    EVAL_FLAT     = 4,
+};
+
+#define ADD_VAR(variables)                                                                   \
+        {                                                                                    \
+            uint32_t symbol = 0;                                                             \
+            char*    name   = nullptr;                                                       \
+                                                                                             \
+            name = internName("pi", 2, symbol); variables.Push({ PI, name, false, symbol }); \
+            name = internName("e",  1, symbol); variables.Push({ E,  name, false, symbol }); \
+            name = internName("i",  1, symbol); variables.Push({ I,  name, false, symbol }); \
         } //
 
 
@@ -80,6 +100,10 @@ enum CalculatorErrors
     CALC_TREE_VAR_WRONG_ARGUMENT                                           ,
     CALC_UNIDENTIFIED_VARIABLE                                             ,
     CALC_WRONG_VARIABLE                                                    ,
+    CALC_SYNTAX_NO_OPERATOR                                                ,
+    CALC_EXPR_FILE_WRONG                                                   ,
+    CALC_EXPR_FILE_VERSION                                                 ,
+    CALC_EXPR_FILE_WRITE_ERROR                                             ,
 };
 
 char const * const calc_errstr[] =
@@ -100,16 +124,27 @@ char const * const calc_errstr[] =
     "Variable node must not have any children"                             ,
     "I do not solve equations"                                             ,
     "Wrong variable detected"                                              ,
+    "Operator required between two operands"                               ,
+    "Compiled expression file is damaged"                                  ,
+    "Compiled expression file has another version or number type"          ,
+    "Failed to write the compiled expression file"                         ,
 };
 
 char const * const CALCULATOR_LOGNAME = "calculator.log";
 
-#define CHECK_SYNTAX(cond, errcode, expr, len) if (cond)                                                                            \
-                                               {                                                                                    \
-                                                 CalcPrintError(CALCULATOR_LOGNAME, __FILE__, __LINE__, __FUNC_NAME__, errcode, 0); \
-                                                 PrintBadExpr(CALCULATOR_LOGNAME, expr, len);                                       \
-                                                 expr.err = errcode;                                                                \
-                                                 return nullptr;                                                                    \
+const size_t BATCH_BLOCK_LINES = 16384;
+const size_t BATCH_RESULT_LEN  = 128;
+const size_t VARIABLES_INLINE  = 16;    // variables kept in the calculator before the heap is used
+
+#define CHECK_SYNTAX(cond, errcode, expr, len) if (cond)                                                                              \
+                                               {                                                                                      \
+                                                 if (not expr.quiet)                                                                  \
+                                                 {                                                                                    \
+                                                   CalcPrintError(CALCULATOR_LOGNAME, __FILE__, __LINE__, __FUNC_NAME__, errcode, 0); \
+                                                   PrintBadExpr(CALCULATOR_LOGNAME, expr, len);                                       \
+                                                 }                                                                                    \
+                                                 expr.err = errcode;                                                                  \
+                                                 return nullptr;                                                                      \
                                                } //
 
 #define CALC_ASSERTOK(cond, err) if (cond)                                                                        \
@@ -137,11 +172,39 @@ enum NODE_TYPE
     NODE_NUMBER   = 4,
 };
 
+enum TokenKinds
+{
+    TOKEN_END    = '\0',
+    TOKEN_ERROR  = '?',
+    TOKEN_NAME   = 'w',
+    TOKEN_NUMBER = 'n',
+    /* operators and brackets are tokens of their own symbol */
+};
+
+struct Token
+{
+    char     kind   = TOKEN_END;
+    unsigned offset = 0;
+    unsigned length = 0;
+};
+
+struct Variable;
+struct CalcNodeData;
+
 struct Expression 
 {
     char* str      = nullptr;
     char* symb_cur = nullptr;
     int   err      = CALC_OK;
+
+    Stack<Variable, VARIABLES_INLINE>* variables = nullptr;
+
+    Token  token  = {};
+    double number = 0;
+
+    NodeArena<CalcNodeData>* arena = nullptr; /* nodes are created by new if there is no arena */
+
+    bool quiet = false; /* syntax errors are not printed */
 };
 
 struct CalcNodeData
@@ -150,6 +213,9 @@ struct CalcNodeData
     char*    word      = nullptr;
     char     op_code   = 0;
     char     node_type = 0;
+    bool     dirty     = true;
+    int      slot      = -1;
+    uint32_t symbol    = 0;     // interned name of the variable, 0 if none
 };
 
 template<> const char* const      PRINT_TYPE<CalcNodeData> = "CalcNodeData";
@@ -161,8 +227,10 @@ void TypePrint (FILE* fp, const CalcNodeData& node_data);
 
 struct Variable
 {
-    NUM_TYPE    value = POISON<NUM_TYPE>;
-    const char* name  = nullptr;
+    NUM_TYPE    value   = POISON<NUM_TYPE>;
+    const char* name    = nullptr;
+    bool        scanned = false;
+    uint32_t    symbol  = 0;
 };
 
 template<> const char* const  PRINT_TYPE<Variable> = "Variable";
@@ -178,11 +246,22 @@ private:
 
     int state_;
     char* filename_;
+    int eval_mode_;
+    int threads_num_;
+    bool real_mode_;
+    bool stats_;
+    char* batch_output_ = nullptr;
+    char* save_file_    = nullptr;
+    bool  load_file_    = false;
+
+    Node<CalcNodeData>*  watched_root_   = nullptr;
+    Node<CalcNodeData>** var_leaves_     = nullptr;
+    size_t               var_leaves_num_ = 0;
 
 public:
 
-    Stack<Tree<CalcNodeData>> trees_;
-    Stack<Variable>           variables_;
+    Stack<Tree<CalcNodeData>>         trees_;
+    Stack<Variable, VARIABLES_INLINE> variables_;
 
 //------------------------------------------------------------------------------
 /*! @brief   Calculator default constructor.
@@ -233,6 +312,140 @@ public:
 
     int Calculate (Node<CalcNodeData>* node_cur, bool with_new_var);
 
+//------------------------------------------------------------------------------
+/*! @brief   Get value of the variable, asks for it if it is not defined yet.
+ *
+ *  @param   varname       Variable name
+ *  @param   symbol        Symbol of the variable name
+ *  @param   with_new_var  If not all required variables are defined on the stack
+ *  @param   number        Value of the variable
+ *
+ *  @return  error code
+ */
+
+    int getVariable (char* varname, uint32_t symbol, bool with_new_var, NUM_TYPE& number);
+
+//------------------------------------------------------------------------------
+/*! @brief   Get value of the variable by its slot, asks for it if it is not defined yet.
+ *
+ *  @param   slot          Index of the variable on the stack
+ *  @param   with_new_var  If not all required variables are defined on the stack
+ *  @param   number        Value of the variable
+ *
+ *  @return  error code
+ */
+
+    int getVariable (int slot, bool with_new_var, NUM_TYPE& number);
+
+//------------------------------------------------------------------------------
+/*! @brief   Get value of the variable by its slot if it was resolved at parse time.
+ *
+ *  @param   varname       Variable name
+ *  @param   symbol        Symbol of the variable name
+ *  @param   slot          Slot of the variable from the parser, -1 if none
+ *  @param   with_new_var  If not all required variables are defined on the stack
+ *  @param   number        Value of the variable
+ *
+ *  @return  error code
+ */
+
+    int getVariable (char* varname, uint32_t symbol, int slot, bool with_new_var, NUM_TYPE& number);
+
+//------------------------------------------------------------------------------
+/*! @brief   Change value of the variable and mark the nodes depending on it.
+ *
+ *  @param   varname       Variable name
+ *  @param   value         New value of the variable
+ *
+ *  @return  error code
+ *
+ *  @note    Only the path from its leaves up to the root becomes dirty.
+ */
+
+    int setVariable (const char* varname, NUM_TYPE value);
+
+//------------------------------------------------------------------------------
+/*! @brief   Recalculate dirty nodes of the expression tree.
+ *
+ *  @return  error code, result is in the root node
+ */
+
+    int reevaluate ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Evaluate one expression over many rows of variable values.
+ *
+ *  @param   tree          Equation tree
+ *  @param   names         Names of variables given by columns
+ *  @param   columns       Columns of variable values, rows_num numbers each
+ *  @param   columns_num   Number of columns
+ *  @param   output        Array for results, rows_num numbers
+ *  @param   rows_num      Number of rows
+ *
+ *  @return  error code
+ *
+ *  @note    Variables without a column are taken from the stack of variables.
+ */
+
+    int EvaluateBatch (Tree<CalcNodeData>& tree, const char* const* names, const NUM_TYPE* const* columns,
+                       size_t columns_num, NUM_TYPE* output, size_t rows_num);
+
+//------------------------------------------------------------------------------
+/*! @brief   Set the way expressions are evaluated in Run.
+ *
+ *  @param   eval_mode     EVAL_TREE, EVAL_FLAT, EVAL_BYTECODE, EVAL_JIT or EVAL_AOT
+ */
+
+    void setEvalMode (int eval_mode);
+
+//------------------------------------------------------------------------------
+/*! @brief   Set number of threads for batch evaluation.
+ *
+ *  @param   threads_num   Number of threads, 0 - all available cores
+ */
+
+    void setThreadsNum (int threads_num);
+
+//------------------------------------------------------------------------------
+/*! @brief   Allow evaluating expressions proven to be real on double.
+ *
+ *  @param   real_mode     true to try the real path first
+ */
+
+    void setRealMode (bool real_mode);
+
+//------------------------------------------------------------------------------
+/*! @brief   Print number of nodes of the tree and of the compiled program.
+ *
+ *  @param   stats         true to print them before the result
+ */
+
+    void setStats (bool stats);
+
+//------------------------------------------------------------------------------
+/*! @brief   Evaluate every line of the input file as a separate expression.
+ *
+ *  @param   outname       Name of the output file, one result per input line
+ */
+
+    void setBatchOutput (char* outname);
+
+//------------------------------------------------------------------------------
+/*! @brief   Compile every line of the input file and save them instead of calculating.
+ *
+ *  @param   filename      Name of the compiled expressions file
+ */
+
+    void setSaveFile (char* filename);
+
+//------------------------------------------------------------------------------
+/*! @brief   Take the input file as compiled expressions saved before.
+ *
+ *  @param   load          If the input file is compiled expressions
+ */
+
+    void setLoadFile (bool load);
+
 /*------------------------------------------------------------------------------
                    Private functions                                           *
 *///----------------------------------------------------------------------------
@@ -241,13 +454,250 @@ private:
 
 //------------------------------------------------------------------------------
 /*! @brief   Write calculated result to console or to file.
+ *
+ *  @param   number      Result of the expression
+ */
+
+    void Write (NUM_TYPE number);
+
+//------------------------------------------------------------------------------
+/*! @brief   Evaluate parsed expression with the chosen evaluation mode.
+ *
+ *  @param   number      Result of the expression
+ *
+ *  @return  error code
+ */
+
+    int Evaluate (NUM_TYPE& number);
+
+//------------------------------------------------------------------------------
+/*! @brief   Evaluate lines of the input file in parallel and write results in order.
+ *
+ *  @return  error code
  */
 
-    void Write ();
+    int RunBatch ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Calculate a block of results in parallel and write them in order.
+ *
+ *  @param   output      Output file, one result per line
+ *  @param   results     Buffer of BATCH_BLOCK_LINES results of BATCH_RESULT_LEN symbols
+ *  @param   num         Number of results in the block
+ *  @param   evaluate    Writes the i-th result of the block to the given slot
+ */
+
+    template <typename EVALUATE>
+    void WriteBlock (FILE* output, char* results, size_t num, EVALUATE evaluate);
+
+//------------------------------------------------------------------------------
+/*! @brief   Parse and calculate one line without asking for variables.
+ *
+ *  @param   line        Line of the input file
+ *  @param   number      Result of the expression
+ *
+ *  @note    Safe to call from several threads, the stack of variables is only read.
+ *
+ *  @return  error code
+ */
+
+    int EvaluateLine (char* line, NUM_TYPE& number);
+
+//------------------------------------------------------------------------------
+/*! @brief   Parse and compile lines of the input file and write them to the save file.
+ *
+ *  @return  error code
+ */
+
+    int RunSave ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Calculate the first or, in batch mode, every compiled expression of the input file.
+ *
+ *  @return  error code
+ */
+
+    int RunLoad ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Calculate one compiled expression without asking for variables.
+ *
+ *  @param   file        Compiled expressions
+ *  @param   index       Index of the expression
+ *  @param   number      Result of the expression
+ *
+ *  @note    Safe to call from several threads, the stack of variables is only read.
+ *
+ *  @return  error code
+ */
+
+    int EvaluateLoaded (ExprFile& file, size_t index, NUM_TYPE& number);
+
+//------------------------------------------------------------------------------
+/*! @brief   Read the variables of the program and run it.
+ *
+ *  @param   program     Compiled program
+ *  @param   func        Native code of the program, nullptr to interpret it
+ *  @param   number      Result of the expression
+ *
+ *  @return  error code
+ */
+
+    int Execute (Program& program, NUM_TYPE (*func)(const NUM_TYPE* vars), NUM_TYPE& number);
+
+//------------------------------------------------------------------------------
+/*! @brief   Recursive recalculation of dirty nodes.
+ *
+ *  @param   node_cur      Current node
+ *
+ *  @return  error code
+ */
+
+    int Recalculate (Node<CalcNodeData>* node_cur);
+
+//------------------------------------------------------------------------------
+/*! @brief   Collect variable leaves of the expression tree.
+ */
+
+    void WatchTree ();
 
 //------------------------------------------------------------------------------
 };
 
+//------------------------------------------------------------------------------
+/*! @brief   Apply function to the number.
+ *
+ *  @param   op_code     Function code
+ *  @param   number      Argument of the function
+ *
+ *  @return  result
+ */
+
+inline NUM_TYPE calcFunction (char op_code, NUM_TYPE number)
+{
+    #define ONE static_cast<NUM_TYPE>(1)
+    #define TWO static_cast<NUM_TYPE>(2)
+
+    switch (op_code)
+    {
+    case OP_ARCCOS:     return acos(number);
+    case OP_ARCCOSH:    return acosh(number);
+    case OP_ARCCOT:     return PI/TWO - atan(number);
+    case OP_ARCCOTH:    return atanh(ONE / number);
+    case OP_ARCSIN:     return asin(number);
+    case OP_ARCSINH:    return asinh(number);
+    case OP_ARCTAN:     return atan(number);
+    case OP_ARCTANH:    return atanh(number);
+    case OP_COS:        return cos(number);
+    case OP_COSH:       return cosh(number);
+    case OP_COT:        return ONE / tan(number);
+    case OP_COTH:       return ONE / tanh(number);
+    case OP_EXP:        return exp(number);
+    case OP_LG:         return log10(number);
+    case OP_LN:         return log(number);
+    case OP_SIN:        return sin(number);
+    case OP_SINH:       return sinh(number);
+    case OP_SQRT:       return sqrt(number);
+    case OP_TAN:        return tan(number);
+    case OP_TANH:       return tanh(number);
+    default: assert(0);
+    }
+
+    #undef ONE
+    #undef TWO
+
+    return POISON<NUM_TYPE>;
+}
+
+//------------------------------------------------------------------------------
+/*! @brief   Apply operator to the numbers.
+ *
+ *  @param   op_code     Operator code
+ *  @param   left_num    Left operand
+ *  @param   right_num   Right operand
+ *
+ *  @return  result
+ */
+
+inline NUM_TYPE calcOperator (char op_code, NUM_TYPE left_num, NUM_TYPE right_num)
+{
+    switch (op_code)
+    {
+    case OP_ADD:  return left_num + right_num;
+    case OP_SUB:  return left_num - right_num;
+    case OP_MUL:  return left_num * right_num;
+    case OP_DIV:  return left_num / right_num;
+    case OP_POW:  return pow(left_num, right_num);
+    default: assert(0);
+    }
+
+    return POISON<NUM_TYPE>;
+}
+
+//------------------------------------------------------------------------------
+/*! @brief   Apply function to the real number.
+ *
+ *  @param   op_code     Function code
+ *  @param   number      Argument of the function
+ *
+ *  @return  result, NAN if it leaves the reals
+ */
+
+inline double calcFunction (char op_code, double number)
+{
+    switch (op_code)
+    {
+    case OP_ARCCOS:     return acos(number);
+    case OP_ARCCOSH:    return acosh(number);
+    case OP_ARCCOT:     return real(PI) / 2 - atan(number);
+    case OP_ARCCOTH:    return atanh(1 / number);
+    case OP_ARCSIN:     return asin(number);
+    case OP_ARCSINH:    return asinh(number);
+    case OP_ARCTAN:     return atan(number);
+    case OP_ARCTANH:    return atanh(number);
+    case OP_COS:        return cos(number);
+    case OP_COSH:       return cosh(number);
+    case OP_COT:        return 1 / tan(number);
+    case OP_COTH:       return 1 / tanh(number);
+    case OP_EXP:        return exp(number);
+    case OP_LG:         return log10(number);
+    case OP_LN:         return log(number);
+    case OP_SIN:        return sin(number);
+    case OP_SINH:       return sinh(number);
+    case OP_SQRT:       return sqrt(number);
+    case OP_TAN:        return tan(number);
+    case OP_TANH:       return tanh(number);
+    default: assert(0);
+    }
+
+    return NAN;
+}
+
+//------------------------------------------------------------------------------
+/*! @brief   Apply operator to the real numbers.
+ *
+ *  @param   op_code     Operator code
+ *  @param   left_num    Left operand
+ *  @param   right_num   Right operand
+ *
+ *  @return  result, NAN if it leaves the reals
+ */
+
+inline double calcOperator (char op_code, double left_num, double right_num)
+{
+    switch (op_code)
+    {
+    case OP_ADD:  return left_num + right_num;
+    case OP_SUB:  return left_num - right_num;
+    case OP_MUL:  return left_num * right_num;
+    case OP_DIV:  return left_num / right_num;
+    case OP_POW:  return pow(left_num, right_num);
+    default: assert(0);
+    }
+
+    return NAN;
+}
+
 //------------------------------------------------------------------------------
 /*! @brief   Prints an error wih description to the console and to the log file.
  *
@@ -290,6 +740,27 @@ NUM_TYPE scanVar (Calculator& calc, char* varname);
 
 char* Num2Str (NUM_TYPE number);
 
+//------------------------------------------------------------------------------
+/*! @brief   Convert complex number to c string.
+ *
+ *  @param   number      Complex number
+ *  @param   str         Buffer for the string
+ *  @param   size        Size of the buffer, the string is cut to it
+ */
+
+void Num2Str (NUM_TYPE number, char* str, size_t size);
+
+//------------------------------------------------------------------------------
+/*! @brief   Convert result of an expression or its error to c string.
+ *
+ *  @param   err         Error code of the calculation
+ *  @param   number      Result of the expression, used if there is no error
+ *  @param   str         Buffer for the string
+ *  @param   size        Size of the buffer, the string is cut to it
+ */
+
+void Result2Str (int err, NUM_TYPE number, char* str, size_t size);
+
 //------------------------------------------------------------------------------
 /*! @brief   Get string equation from stdin.
  * 
@@ -332,85 +803,91 @@ int Node2Str (Node<CalcNodeData>* node_cur, char** str);
 int Expr2Tree (Expression& expr, Tree<CalcNodeData>& tree);
 
 //------------------------------------------------------------------------------
-/*! @brief   Parsing of expression beginning with plus and minus signs.
- * 
- *  @param   expr        String expression
+/*! @brief   Scan the next token of the expression, spaces are skipped.
  *
- *  @return  pointer to tree node
+ *  @param   expr        String expression, symb_cur points to the new token
  */
 
-Node<CalcNodeData>* pass_Plus_Minus (Expression& expr);
+void NextToken (Expression& expr);
 
 //------------------------------------------------------------------------------
-/*! @brief   Parsing of expression with mulptiply and division signs.
- * 
- *  @param   expr        String expression
+/*! @brief   Parsing of the whole expression with operators, brackets and functions.
+ *
+ *  @param   expr        String expression, token is the first one
+ *
+ *  @note    Operators and brackets are kept on the heap stacks, not in the
+ *           recursion, so the nesting depth is limited by the memory only.
  *
  *  @return  pointer to tree node
  */
 
-Node<CalcNodeData>* pass_Mul_Div (Expression& expr);
+Node<CalcNodeData>* pass_Expression (Expression& expr);
 
 //------------------------------------------------------------------------------
-/*! @brief   Parsing of expression with power signs.
+/*! @brief   Parsing of expression with number.
  * 
  *  @param   expr        String expression
  *
  *  @return  pointer to tree node
  */
 
-Node<CalcNodeData>* pass_Power (Expression& expr);
+Node<CalcNodeData>* pass_Number (Expression& expr);
 
 //------------------------------------------------------------------------------
-/*! @brief   Parsing of expression with brackets.
- * 
- *  @param   expr        String expression
+/*! @brief   Check if there are need brackets for operator.
  *
- *  @return  pointer to tree node
+ *  @param   node_cur    Current node
+ *  @param   child       Current node's child
+ *
+ *  @return  true if need, else false
  */
 
-Node<CalcNodeData>* pass_Brackets (Expression& expr);
+bool needBrackets (Node<CalcNodeData>* node, Node<CalcNodeData>* child);
 
 //------------------------------------------------------------------------------
-/*! @brief   Parsing of expression with function.
- * 
- *  @param   expr        String expression
+/*! @brief   Function identifier.
  *
- *  @return  pointer to tree node
+ *  @param   word        C string to be recognized
+ *
+ *  @return  function code if found else NOT_OK
  */
 
-Node<CalcNodeData>* pass_Function (Expression& expr);
+char findFunc (char* word);
 
 //------------------------------------------------------------------------------
-/*! @brief   Parsing of expression with number.
- * 
- *  @param   expr        String expression
+/*! @brief   Function identifier.
  *
- *  @return  pointer to tree node
+ *  @param   word        Name to be recognized, not null-terminated
+ *  @param   len         Length of the name
+ *
+ *  @return  function code if found else NOT_OK
  */
 
-Node<CalcNodeData>* pass_Number (Expression& expr);
+char findFunc (const char* word, size_t len);
 
 //------------------------------------------------------------------------------
-/*! @brief   Check if there are need brackets for operator.
+/*! @brief   Get the only copy of the name and its symbol, names are never freed.
  *
- *  @param   node_cur    Current node
- *  @param   child       Current node's child
+ *  @param   word        Name, not null-terminated
+ *  @param   len         Length of the name
+ *  @param   symbol      Number of the name in the pool, equal names have equal symbols
  *
- *  @return  true if need, else false
+ *  @return  null-terminated name from the pool
  */
 
-bool needBrackets (Node<CalcNodeData>* node, Node<CalcNodeData>* child);
+char* internName (const char* word, size_t len, uint32_t& symbol);
 
 //------------------------------------------------------------------------------
-/*! @brief   Function identifier.
+/*! @brief   Get slot of the variable, adds it undefined if it is not present yet.
  *
- *  @param   word        C string to be recognized
+ *  @param   variables   Stack of variables
+ *  @param   varname     Variable name
+ *  @param   symbol      Symbol of the variable name
  *
- *  @return  function code if found else NOT_OK
+ *  @return  slot of the variable
  */
 
-char findFunc (char* word);
+int findVariable (Stack<Variable, VARIABLES_INLINE>& variables, char* varname, uint32_t symbol);
 
 //------------------------------------------------------------------------------
 /*! @brief   Optimize expression process.
@@ -421,15 +898,15 @@ char findFunc (char* word);
 void Optimize (Tree<CalcNodeData>& tree);
 
 //------------------------------------------------------------------------------
-/*! @brief   Optimize expression process.
+/*! @brief   Fold constant subtrees and identities of the subtree in post-order.
  *
  *  @param   tree        Tree to optimize
  *  @param   node_cur    Node to optimize
  *
- *  @return  return 0 if optimized, else 1
+ *  @return  node standing in place of node_cur after optimization
  */
 
-bool Optimize (Tree<CalcNodeData>& tree, Node<CalcNodeData>* node_cur);
+Node<CalcNodeData>* Optimize (Tree<CalcNodeData>& tree, Node<CalcNodeData>* node_cur);
 
 //------------------------------------------------------------------------------
 /*! @brief   Check if value is POISON.
@@ -0,0 +1,516 @@
+/*------------------------------------------------------------------------------
+    * File:        ExprFile.cpp                                                *
+    * Description: Binary file of parsed and compiled expressions, it is       *
+    *              mapped and used without parsing.                            *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+#include "ExprFile.h"
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+
+static const size_t section_elem_size[SECTIONS_NUM] =
+{
+    sizeof(ExprFileEntry),
+    sizeof(ExprFileNode),
+    sizeof(char),
+    sizeof(Instruction),
+    sizeof(NUM_TYPE),
+    sizeof(uint32_t),
+};
+
+static const size_t SECTION_START_SIZE = 4096;
+
+//------------------------------------------------------------------------------
+
+static size_t AlignUp (size_t size)
+{
+    return (size + EXPR_FILE_ALIGN - 1) / EXPR_FILE_ALIGN * EXPR_FILE_ALIGN;
+}
+
+//------------------------------------------------------------------------------
+
+ExprFileWriter::ExprFileWriter () :
+    state_ (CALC_OK)
+{
+    for (int i = 0; i < SECTIONS_NUM; ++i)
+        sections_[i] = new BinCode(SECTION_START_SIZE);
+}
+
+//------------------------------------------------------------------------------
+
+ExprFileWriter::~ExprFileWriter ()
+{
+    if (state_ != CALC_OK) return;
+
+    for (int i = 0; i < SECTIONS_NUM; ++i)
+    {
+        delete sections_[i];
+        sections_[i] = nullptr;
+    }
+
+    delete [] name_offsets_;
+    name_offsets_     = nullptr;
+    name_offsets_num_ = 0;
+
+    state_ = CALC_DESTRUCTED;
+}
+
+//------------------------------------------------------------------------------
+
+int ExprFileWriter::Add (Tree<CalcNodeData>& tree, const Program* program)
+{
+    CALC_ASSERTOK((tree.root_ == nullptr), CALC_NOT_OK);
+
+    size_t nodes_num = CountNodes(tree.root_);
+
+    ExprFileEntry entry = {};
+    entry.nodes_begin = (uint32_t)(sections_[SECTION_NODES]->ptr_ / sizeof(ExprFileNode));
+    entry.nodes_num   = (uint32_t)nodes_num;
+
+    /* all indices of the file are 32-bit */
+    if ((uint64_t)entry.nodes_begin + nodes_num >= FLAT_NULL) return CALC_EXPR_FILE_WRITE_ERROR;
+
+    /* indices of the finished subtrees wait here for their parent */
+    uint32_t* done     = new uint32_t[nodes_num];
+    size_t    done_num = 0;
+    uint32_t  index    = 0;
+
+    Node<CalcNodeData>* node_cur = tree.root_;
+    while ((node_cur->left_ != nullptr) || (node_cur->right_ != nullptr))
+        node_cur = (node_cur->left_ != nullptr) ? node_cur->left_ : node_cur->right_;
+
+    /* post-order walk by prev_, the same as the flat expression has */
+    while (true)
+    {
+        const CalcNodeData& data = node_cur->getData();
+
+        ExprFileNode node = {};
+        node.op_code   = data.op_code;
+        node.node_type = data.node_type;
+
+        node.right = (node_cur->right_ != nullptr) ? done[--done_num] : FLAT_NULL;
+        node.left  = (node_cur->left_  != nullptr) ? done[--done_num] : FLAT_NULL;
+
+        if (data.node_type == NODE_NUMBER)
+            node.number = data.number;
+        else
+        if (data.node_type == NODE_VARIABLE)
+            node.name = AddName(data.word, data.symbol);
+
+        sections_[SECTION_NODES]->Put(&node, sizeof(node));
+        done[done_num++] = index++;
+
+        if (node_cur == tree.root_) break;
+
+        Node<CalcNodeData>* prev = node_cur->prev_;
+
+        if ((node_cur == prev->left_) && (prev->right_ != nullptr))
+        {
+            node_cur = prev->right_;
+            while ((node_cur->left_ != nullptr) || (node_cur->right_ != nullptr))
+                node_cur = (node_cur->left_ != nullptr) ? node_cur->left_ : node_cur->right_;
+        }
+        else
+            node_cur = prev;
+    }
+
+    delete [] done;
+
+    if (program != nullptr)
+    {
+        entry.code_begin   = (uint32_t)(sections_[SECTION_CODE]->ptr_   / sizeof(Instruction));
+        entry.code_num     = (uint32_t)program->size_;
+        entry.consts_begin = (uint32_t)(sections_[SECTION_CONSTS]->ptr_ / sizeof(NUM_TYPE));
+        entry.consts_num   = (uint32_t)program->consts_num_;
+        entry.vars_begin   = (uint32_t)(sections_[SECTION_VARS]->ptr_   / sizeof(uint32_t));
+        entry.vars_num     = (uint32_t)program->vars_num_;
+        entry.regs_num     = (uint32_t)program->regs_num_;
+
+        for (size_t i = 0; i < program->size_; ++i)
+        {
+            const Instruction& ins = program->code_[i];
+
+            /* padding of the instruction goes to the file too, so it is zero */
+            unsigned char bytes[sizeof(Instruction)] = {};
+
+            memcpy(bytes + offsetof(Instruction, dst),   &ins.dst,   sizeof(ins.dst));
+            memcpy(bytes + offsetof(Instruction, left),  &ins.left,  sizeof(ins.left));
+            memcpy(bytes + offsetof(Instruction, right), &ins.right, sizeof(ins.right));
+            memcpy(bytes + offsetof(Instruction, code),  &ins.code,  sizeof(ins.code));
+
+            sections_[SECTION_CODE]->Put(bytes, sizeof(bytes));
+        }
+
+        sections_[SECTION_CONSTS]->Put(program->consts_, program->consts_num_ * sizeof(NUM_TYPE));
+
+        for (size_t i = 0; i < program->vars_num_; ++i)
+        {
+            uint32_t name = AddName(program->vars_[i], program->var_symbols_[i]);
+            sections_[SECTION_VARS]->Put(&name, sizeof(name));
+        }
+    }
+
+    sections_[SECTION_EXPRS]->Put(&entry, sizeof(entry));
+    ++exprs_num_;
+
+    return CALC_OK;
+}
+
+//------------------------------------------------------------------------------
+
+int ExprFileWriter::Write (const char* filename)
+{
+    assert(filename != nullptr);
+
+    ExprFileHeader header = {};
+    header.exprs_num = exprs_num_;
+
+    size_t offset = AlignUp(sizeof(header));
+    for (int i = 0; i < SECTIONS_NUM; ++i)
+    {
+        header.sections[i].offset = offset;
+        header.sections[i].num    = sections_[i]->ptr_ / section_elem_size[i];
+
+        offset = AlignUp(offset + sections_[i]->ptr_);
+    }
+
+    BinCode file(offset);
+    file.Put(&header, sizeof(header));
+
+    const char zeros[EXPR_FILE_ALIGN] = {};
+    for (int i = 0; i < SECTIONS_NUM; ++i)
+    {
+        file.Put(zeros, header.sections[i].offset - file.ptr_);
+        file.Put(sections_[i]->data_, sections_[i]->ptr_);
+    }
+
+    if (file.Write(filename) != STR_OK) return CALC_EXPR_FILE_WRITE_ERROR;
+
+    return CALC_OK;
+}
+
+//------------------------------------------------------------------------------
+
+uint32_t ExprFileWriter::AddName (const char* name, uint32_t symbol)
+{
+    assert(name != nullptr);
+
+    /* symbols are dense, so the offsets of the added names are found by them */
+    if (symbol >= name_offsets_num_)
+    {
+        size_t    offsets_num = (name_offsets_num_ == 0) ? 64 : name_offsets_num_;
+        while (offsets_num <= symbol) offsets_num *= 2;
+
+        uint32_t* offsets = new uint32_t[offsets_num];
+
+        for (size_t i = 0; i < offsets_num; ++i)
+            offsets[i] = (i < name_offsets_num_) ? name_offsets_[i] : FLAT_NULL;
+
+        delete [] name_offsets_;
+        name_offsets_     = offsets;
+        name_offsets_num_ = offsets_num;
+    }
+
+    if (name_offsets_[symbol] == FLAT_NULL)
+    {
+        name_offsets_[symbol] = (uint32_t)sections_[SECTION_NAMES]->ptr_;
+        sections_[SECTION_NAMES]->Put(name, strlen(name) + 1);
+    }
+
+    return name_offsets_[symbol];
+}
+
+//------------------------------------------------------------------------------
+
+ExprFile::ExprFile (const char* filename) :
+    state_ (CALC_OK),
+    data_  (filename, TEXT_MAP)
+{
+    state_ = Check();
+    if (state_ != CALC_OK) return;
+
+    const char* data = data_.data_;
+
+    exprs_  = (const ExprFileEntry*)(data + header_->sections[SECTION_EXPRS].offset);
+    nodes_  = (const ExprFileNode*) (data + header_->sections[SECTION_NODES].offset);
+    names_  = (const char*)         (data + header_->sections[SECTION_NAMES].offset);
+    code_   = (const Instruction*)  (data + header_->sections[SECTION_CODE].offset);
+    consts_ = (const NUM_TYPE*)     (data + header_->sections[SECTION_CONSTS].offset);
+    vars_   = (const uint32_t*)     (data + header_->sections[SECTION_VARS].offset);
+
+    exprs_num_ = header_->exprs_num;
+}
+
+//------------------------------------------------------------------------------
+
+ExprFile::~ExprFile ()
+{
+    if (state_ == CALC_DESTRUCTED) return;
+
+    header_ = nullptr;
+    exprs_  = nullptr;
+    nodes_  = nullptr;
+    names_  = nullptr;
+    code_   = nullptr;
+    consts_ = nullptr;
+    vars_   = nullptr;
+
+    exprs_num_ = 0;
+
+    state_ = CALC_DESTRUCTED;
+}
+
+//------------------------------------------------------------------------------
+
+int ExprFile::getTree (size_t index, Tree<CalcNodeData>& tree, Stack<Variable, VARIABLES_INLINE>* variables)
+{
+    CALC_ASSERTOK(state_, state_);
+    assert(index < exprs_num_);
+    assert(tree.root_ == nullptr);
+
+    const ExprFileEntry& expr  = exprs_[index];
+    const ExprFileNode*  nodes = nodes_ + expr.nodes_begin;
+
+    /* the file is checked, so children are always made before their parents */
+    Node<CalcNodeData>** made = new Node<CalcNodeData>*[expr.nodes_num];
+
+    for (uint32_t i = 0; i < expr.nodes_num; ++i)
+    {
+        const ExprFileNode& node = nodes[i];
+        Node<CalcNodeData>* node_cur = tree.NewNode();
+
+        switch (node.node_type)
+        {
+        case NODE_NUMBER:
+            node_cur->setData({ node.number, nullptr, 0, NODE_NUMBER });
+            break;
+
+        case NODE_VARIABLE:
+        {
+            const char* name = names_ + node.name;
+
+            uint32_t symbol  = 0;
+            char*    varname = internName(name, strlen(name), symbol);
+            int      slot    = (variables != nullptr) ? findVariable(*variables, varname, symbol) : -1;
+
+            node_cur->setData({ POISON<NUM_TYPE>, varname, 0, NODE_VARIABLE, true, slot, symbol });
+            break;
+        }
+
+        default:
+            node_cur->setData({ POISON<NUM_TYPE>, op_names[(int)node.op_code].word, node.op_code, node.node_type });
+        }
+
+        if (node.left != FLAT_NULL)
+        {
+            node_cur->left_ = made[node.left];
+            node_cur->left_->prev_ = node_cur;
+        }
+
+        if (node.right != FLAT_NULL)
+        {
+            node_cur->right_ = made[node.right];
+            node_cur->right_->prev_ = node_cur;
+        }
+
+        made[i] = node_cur;
+    }
+
+    tree.root_ = made[expr.nodes_num - 1];
+    tree.root_->prev_ = nullptr;
+    tree.root_->recountDepth();
+
+    delete [] made;
+
+    return CALC_OK;
+}
+
+//------------------------------------------------------------------------------
+
+bool ExprFile::hasProgram (size_t index)
+{
+    assert(index < exprs_num_);
+
+    return exprs_[index].code_num != 0;
+}
+
+//------------------------------------------------------------------------------
+
+int ExprFile::getErrCode ()
+{
+    return state_;
+}
+
+//------------------------------------------------------------------------------
+
+int ExprFile::Check ()
+{
+    if (data_.size_ < sizeof(ExprFileHeader)) return CALC_EXPR_FILE_WRONG;
+
+    header_ = (const ExprFileHeader*)data_.data_;
+
+    if (header_->magic != EXPR_FILE_MAGIC) return CALC_EXPR_FILE_WRONG;
+
+    if ((header_->version != EXPR_FILE_VERSION) || (header_->num_size != NUM_TYPE_SIZE))
+        return CALC_EXPR_FILE_VERSION;
+
+    for (int i = 0; i < SECTIONS_NUM; ++i)
+    {
+        uint64_t offset = header_->sections[i].offset;
+        uint64_t num    = header_->sections[i].num;
+
+        if ((offset % EXPR_FILE_ALIGN != 0) || (offset < sizeof(ExprFileHeader)) || (offset > data_.size_))
+            return CALC_EXPR_FILE_WRONG;
+
+        if (num > (data_.size_ - offset) / section_elem_size[i]) return CALC_EXPR_FILE_WRONG;
+    }
+
+    if (header_->exprs_num != header_->sections[SECTION_EXPRS].num) return CALC_EXPR_FILE_WRONG;
+
+    /* a name can be read up to its zero if the table ends with zero */
+    uint64_t names_size = header_->sections[SECTION_NAMES].num;
+    if ((names_size != 0) && (data_.data_[header_->sections[SECTION_NAMES].offset + names_size - 1] != '\0'))
+        return CALC_EXPR_FILE_WRONG;
+
+    const ExprFileEntry* exprs = (const ExprFileEntry*)(data_.data_ + header_->sections[SECTION_EXPRS].offset);
+
+    for (size_t i = 0; i < header_->exprs_num; ++i)
+    {
+        int err = CheckExpr(exprs[i]);
+        if (err) return err;
+    }
+
+    return CALC_OK;
+}
+
+//------------------------------------------------------------------------------
+
+int ExprFile::CheckExpr (const ExprFileEntry& expr)
+{
+    const ExprFileSection* sections = header_->sections;
+
+    if ((expr.nodes_num == 0) || ((uint64_t)expr.nodes_begin  + expr.nodes_num  > sections[SECTION_NODES].num))
+        return CALC_EXPR_FILE_WRONG;
+
+    if (((uint64_t)expr.code_begin   + expr.code_num   > sections[SECTION_CODE].num)   ||
+        ((uint64_t)expr.consts_begin + expr.consts_num > sections[SECTION_CONSTS].num) ||
+        ((uint64_t)expr.vars_begin   + expr.vars_num   > sections[SECTION_VARS].num))
+        return CALC_EXPR_FILE_WRONG;
+
+    const char*         data  = data_.data_;
+    const ExprFileNode* nodes = (const ExprFileNode*)(data + sections[SECTION_NODES].offset) + expr.nodes_begin;
+
+    /*
+     * Nodes are taken as the post-order walk takes them: each node takes
+     * its children from the top of the finished subtrees, so every node
+     * except the root has exactly one parent made after it.
+     */
+    uint32_t* done     = new uint32_t[expr.nodes_num];
+    size_t    done_num = 0;
+    int       err      = CALC_OK;
+
+    for (uint32_t i = 0; (i < expr.nodes_num) && (err == CALC_OK); ++i)
+    {
+        const ExprFileNode& node = nodes[i];
+
+        bool has_left  = (node.left  != FLAT_NULL);
+        bool has_right = (node.right != FLAT_NULL);
+
+        switch (node.node_type)
+        {
+        case NODE_NUMBER:
+            if (has_left || has_right) err = CALC_EXPR_FILE_WRONG;
+            break;
+
+        case NODE_VARIABLE:
+            if (has_left || has_right || (node.name >= sections[SECTION_NAMES].num)) err = CALC_EXPR_FILE_WRONG;
+            break;
+
+        case NODE_OPERATOR:
+            /* unary minus has no left child */
+            if ((node.op_code < OP_ADD) || (node.op_code > OP_POW) || not has_right ||
+                (not has_left && (node.op_code != OP_SUB)))
+                err = CALC_EXPR_FILE_WRONG;
+            break;
+
+        case NODE_FUNCTION:
+            if ((node.op_code < OP_ARCCOS) || (node.op_code > OP_TANH) || has_left || not has_right)
+                err = CALC_EXPR_FILE_WRONG;
+            break;
+
+        default:
+            err = CALC_EXPR_FILE_WRONG;
+        }
+
+        if (err) break;
+
+        if (has_right)
+        {
+            if ((done_num == 0) || (done[done_num - 1] != node.right)) err = CALC_EXPR_FILE_WRONG;
+            else --done_num;
+        }
+
+        if (has_left && (err == CALC_OK))
+        {
+            if ((done_num == 0) || (done[done_num - 1] != node.left)) err = CALC_EXPR_FILE_WRONG;
+            else --done_num;
+        }
+
+        done[done_num++] = i;
+    }
+
+    delete [] done;
+
+    if (err) return err;
+    if (done_num != 1) return CALC_EXPR_FILE_WRONG;
+
+    if (expr.code_num == 0) return CALC_OK;
+    /* every instruction takes one register at most */
+    if ((expr.regs_num == 0) || (expr.regs_num > expr.code_num)) return CALC_EXPR_FILE_WRONG;
+
+    const Instruction* code = (const Instruction*)(data + sections[SECTION_CODE].offset) + expr.code_begin;
+
+    for (uint32_t i = 0; i < expr.code_num; ++i)
+    {
+        const Instruction& ins = code[i];
+
+        if (ins.dst >= expr.regs_num) return CALC_EXPR_FILE_WRONG;
+
+        if (ins.code == BC_NUMBER)
+        {
+            if (ins.left >= expr.consts_num) return CALC_EXPR_FILE_WRONG;
+        }
+        else
+        if (ins.code == BC_VARIABLE)
+        {
+            if (ins.left >= expr.vars_num) return CALC_EXPR_FILE_WRONG;
+        }
+        else
+        if ((OP_ADD <= ins.code) && (ins.code <= OP_POW))
+        {
+            if ((ins.left >= expr.regs_num) || (ins.right >= expr.regs_num)) return CALC_EXPR_FILE_WRONG;
+        }
+        else
+        if ((OP_ARCCOS <= ins.code) && (ins.code <= OP_TANH))
+        {
+            if (ins.right >= expr.regs_num) return CALC_EXPR_FILE_WRONG;
+        }
+        else
+            return CALC_EXPR_FILE_WRONG;
+    }
+
+    const uint32_t* vars = (const uint32_t*)(data + sections[SECTION_VARS].offset) + expr.vars_begin;
+
+    for (uint32_t i = 0; i < expr.vars_num; ++i)
+        if (vars[i] >= sections[SECTION_NAMES].num) return CALC_EXPR_FILE_WRONG;
+
+    return CALC_OK;
+}
+
+//------------------------------------------------------------------------------
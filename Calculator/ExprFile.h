@@ -0,0 +1,278 @@
+/*------------------------------------------------------------------------------
+    * File:        ExprFile.h                                                  *
+    * Description: Declaration of the binary file of compiled expressions.     *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+#ifndef EXPRFILE_H_INCLUDED
+#define EXPRFILE_H_INCLUDED
+
+#include "Bytecode.h"
+#include "../TreeLib/FlatTree.h"
+
+
+//==============================================================================
+/*------------------------------------------------------------------------------
+                   ExprFile constants and types                                *
+*///----------------------------------------------------------------------------
+//==============================================================================
+
+
+const uint32_t EXPR_FILE_MAGIC   = 0x50584543; // "CEXP"
+const uint32_t EXPR_FILE_VERSION = 1;
+const size_t   EXPR_FILE_ALIGN   = 16;
+
+enum ExprFileSections
+{
+    SECTION_EXPRS  = 0,
+    SECTION_NODES  = 1,
+    SECTION_NAMES  = 2,
+    SECTION_CODE   = 3,
+    SECTION_CONSTS = 4,
+    SECTION_VARS   = 5,
+
+    SECTIONS_NUM
+};
+
+/*
+ * The header is followed by the sections, each of them starts at its offset
+ * aligned to EXPR_FILE_ALIGN. num is the number of elements, bytes for names.
+ */
+
+struct ExprFileSection
+{
+    uint64_t offset = 0;
+    uint64_t num    = 0;
+};
+
+struct ExprFileHeader
+{
+    uint32_t magic     = EXPR_FILE_MAGIC;
+    uint32_t version   = EXPR_FILE_VERSION;
+    uint32_t num_size  = NUM_TYPE_SIZE;
+    uint32_t exprs_num = 0;
+
+    ExprFileSection sections[SECTIONS_NUM] = {};
+};
+
+/*
+ * Nodes of an expression go in post-order, so the last one is the root.
+ * Program of the expression is not kept if code_num is 0.
+ */
+
+struct ExprFileEntry
+{
+    uint32_t nodes_begin  = 0;
+    uint32_t nodes_num    = 0;
+    uint32_t code_begin   = 0;
+    uint32_t code_num     = 0;
+    uint32_t consts_begin = 0;
+    uint32_t consts_num   = 0;
+    uint32_t vars_begin   = 0;
+    uint32_t vars_num     = 0;
+    uint32_t regs_num     = 0;
+    uint32_t padding      = 0;
+};
+
+/*
+ * Children are indices inside the expression, name is the offset of the
+ * variable name in the names section. Symbols are given on loading.
+ */
+
+struct ExprFileNode
+{
+    NUM_TYPE number    = 0;
+    uint32_t left      = FLAT_NULL;
+    uint32_t right     = FLAT_NULL;
+    uint32_t name      = FLAT_NULL;
+    char     op_code   = 0;
+    char     node_type = 0;
+    char     padding[2] = {};
+};
+
+
+class ExprFileWriter
+{
+    int state_;
+
+    BinCode* sections_[SECTIONS_NUM] = {};
+
+    uint32_t* name_offsets_     = nullptr;
+    size_t    name_offsets_num_ = 0;
+
+public:
+
+    uint32_t exprs_num_ = 0;
+
+//------------------------------------------------------------------------------
+/*! @brief   ExprFileWriter constructor.
+ */
+
+    ExprFileWriter ();
+
+//------------------------------------------------------------------------------
+/*! @brief   ExprFileWriter copy constructor (deleted).
+ *
+ *  @param   obj         Source writer
+ */
+
+    ExprFileWriter (const ExprFileWriter& obj);
+
+    ExprFileWriter& operator = (const ExprFileWriter& obj); // deleted
+
+//------------------------------------------------------------------------------
+/*! @brief   ExprFileWriter destructor.
+ */
+
+   ~ExprFileWriter ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Add the expression to the file.
+ *
+ *  @param   tree        Equation tree
+ *  @param   program     Compiled tree, nullptr if it is not kept
+ *
+ *  @return  error code
+ */
+
+    int Add (Tree<CalcNodeData>& tree, const Program* program);
+
+//------------------------------------------------------------------------------
+/*! @brief   Write all added expressions to the file.
+ *
+ *  @param   filename    Name of the output file
+ *
+ *  @return  error code
+ */
+
+    int Write (const char* filename);
+
+/*------------------------------------------------------------------------------
+                   Private functions                                           *
+*///----------------------------------------------------------------------------
+
+private:
+
+//------------------------------------------------------------------------------
+/*! @brief   Get offset of the name in the names section, adds it once.
+ *
+ *  @param   name        Variable name
+ *  @param   symbol      Symbol of the variable name
+ *
+ *  @return  offset of the name
+ */
+
+    uint32_t AddName (const char* name, uint32_t symbol);
+
+//------------------------------------------------------------------------------
+};
+
+
+class ExprFile
+{
+    int state_;
+
+    BinCode data_;
+
+public:
+
+    const ExprFileHeader* header_ = nullptr;
+    const ExprFileEntry*  exprs_  = nullptr;
+    const ExprFileNode*   nodes_  = nullptr;
+    const char*           names_  = nullptr;
+    const Instruction*    code_   = nullptr;
+    const NUM_TYPE*       consts_ = nullptr;
+    const uint32_t*       vars_   = nullptr;
+
+    size_t exprs_num_ = 0;
+
+//------------------------------------------------------------------------------
+/*! @brief   Map the file and check it, nothing is parsed.
+ *
+ *  @param   filename    Name of the compiled expressions file
+ *
+ *  @note    State of the file is an error code if it can not be used.
+ */
+
+    ExprFile (const char* filename);
+
+//------------------------------------------------------------------------------
+/*! @brief   ExprFile copy constructor (deleted).
+ *
+ *  @param   obj         Source file
+ */
+
+    ExprFile (const ExprFile& obj);
+
+    ExprFile& operator = (const ExprFile& obj); // deleted
+
+//------------------------------------------------------------------------------
+/*! @brief   ExprFile destructor.
+ */
+
+   ~ExprFile ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Build the tree of the expression.
+ *
+ *  @param   index       Index of the expression
+ *  @param   tree        Empty tree for the expression
+ *  @param   variables   Stack of variables to find slots in, nullptr if none
+ *
+ *  @return  error code
+ */
+
+    int getTree (size_t index, Tree<CalcNodeData>& tree, Stack<Variable, VARIABLES_INLINE>* variables = nullptr);
+
+//------------------------------------------------------------------------------
+/*! @brief   Check if the program of the expression is kept.
+ *
+ *  @param   index       Index of the expression
+ *
+ *  @return  true if kept, else false
+ */
+
+    bool hasProgram (size_t index);
+
+//------------------------------------------------------------------------------
+/*! @brief   Get state of the file.
+ *
+ *  @return  CALC_OK or error code of the file
+ */
+
+    int getErrCode ();
+
+/*------------------------------------------------------------------------------
+                   Private functions                                           *
+*///----------------------------------------------------------------------------
+
+private:
+
+//------------------------------------------------------------------------------
+/*! @brief   Check the header, the sections and all expressions.
+ *
+ *  @return  error code
+ */
+
+    int Check ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Check the nodes and the program of the expression.
+ *
+ *  @param   expr        Expression entry
+ *
+ *  @return  error code
+ */
+
+    int CheckExpr (const ExprFileEntry& expr);
+
+//------------------------------------------------------------------------------
+};
+
+//------------------------------------------------------------------------------
+
+#endif // EXPRFILE_H_INCLUDED
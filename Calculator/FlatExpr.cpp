@@ -0,0 +1,246 @@
+/*------------------------------------------------------------------------------
+    * File:        FlatExpr.cpp                                                *
+    * Description: Expression trees stored in the flat arrays and their        *
+    *              evaluation by one pass over the arrays.                     *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+#include "FlatExpr.h"
+
+/* initial size of the variable table, it is doubled when full */
+const size_t FLAT_VARS_CAPACITY = 4;
+
+//------------------------------------------------------------------------------
+
+static size_t CountNumbers (Node<CalcNodeData>* root)
+{
+    size_t numbers_num = 0;
+    for (Node<CalcNodeData>* node_cur = root->firstPostorder(); node_cur != nullptr; node_cur = node_cur->nextPostorder(root))
+        if (node_cur->getData().node_type == NODE_NUMBER) ++numbers_num;
+
+    return numbers_num;
+}
+
+//------------------------------------------------------------------------------
+
+FlatExpr::FlatExpr (Tree<CalcNodeData>& tree) :
+    state_ (CALC_OK),
+    tree_  (CountNodes(tree.root_))
+{
+    CALC_ASSERTOK((tree.root_ == nullptr), CALC_NOT_OK);
+
+    /* numbers are not shared, so there are as many of them as number leaves */
+    numbers_ = new NUM_TYPE[CountNumbers(tree.root_)];
+
+    vars_capacity_ = FLAT_VARS_CAPACITY;
+    vars_          = new char*   [vars_capacity_];
+    var_symbols_   = new uint32_t[vars_capacity_];
+    var_slots_     = new int     [vars_capacity_];
+
+    /* indices of the finished subtrees wait here for their parent */
+    uint32_t* done     = new uint32_t[tree_.capacity_];
+    size_t    done_num = 0;
+
+    Node<CalcNodeData>* node_cur = tree.root_;
+    while ((node_cur->left_ != nullptr) || (node_cur->right_ != nullptr))
+        node_cur = (node_cur->left_ != nullptr) ? node_cur->left_ : node_cur->right_;
+
+    /* post-order walk by prev_, the left subtree goes first */
+    while (true)
+    {
+        const CalcNodeData& data = node_cur->getData();
+        FlatCalcData flat = { 0, data.op_code, data.node_type };
+
+        uint32_t right = (node_cur->right_ != nullptr) ? done[--done_num] : FLAT_NULL;
+        uint32_t left  = (node_cur->left_  != nullptr) ? done[--done_num] : FLAT_NULL;
+
+        if (data.node_type == NODE_NUMBER)
+        {
+            flat.payload = (uint32_t)numbers_num_;
+            numbers_[numbers_num_++] = data.number;
+        }
+        else
+        if (data.node_type == NODE_VARIABLE)
+            flat.payload = findVar(data.word, data.symbol, data.slot);
+
+        done[done_num++] = tree_.Add(flat, left, right);
+
+        if (node_cur == tree.root_) break;
+
+        Node<CalcNodeData>* prev = node_cur->prev_;
+
+        if ((node_cur == prev->left_) && (prev->right_ != nullptr))
+        {
+            node_cur = prev->right_;
+            while ((node_cur->left_ != nullptr) || (node_cur->right_ != nullptr))
+                node_cur = (node_cur->left_ != nullptr) ? node_cur->left_ : node_cur->right_;
+        }
+        else
+            node_cur = prev;
+    }
+
+    delete [] done;
+
+    /* one value per node, the pass over the arrays writes them in place */
+    values_ = new NUM_TYPE[tree_.size_];
+}
+
+//------------------------------------------------------------------------------
+
+FlatExpr::~FlatExpr ()
+{
+    if (state_ != CALC_OK) return;
+
+    delete [] numbers_;
+    delete [] vars_;
+    delete [] var_symbols_;
+    delete [] var_slots_;
+    delete [] values_;
+
+    numbers_     = nullptr;
+    vars_        = nullptr;
+    var_symbols_ = nullptr;
+    var_slots_   = nullptr;
+    values_      = nullptr;
+
+    state_ = CALC_DESTRUCTED;
+}
+
+//------------------------------------------------------------------------------
+
+uint32_t FlatExpr::findVar (char* varname, uint32_t symbol, int slot)
+{
+    assert(varname != nullptr);
+
+    for (size_t i = 0; i < vars_num_; ++i)
+        if (var_symbols_[i] == symbol)
+            return i;
+
+    if (vars_num_ == vars_capacity_) GrowVars();
+
+    vars_       [vars_num_] = varname;
+    var_symbols_[vars_num_] = symbol;
+    var_slots_  [vars_num_] = slot;
+
+    return vars_num_++;
+}
+
+//------------------------------------------------------------------------------
+
+void FlatExpr::GrowVars ()
+{
+    size_t capacity = 2 * vars_capacity_;
+
+    char**    vars        = new char*   [capacity];
+    uint32_t* var_symbols = new uint32_t[capacity];
+    int*      var_slots   = new int     [capacity];
+
+    memcpy(vars,        vars_,        vars_num_ * sizeof(char*));
+    memcpy(var_symbols, var_symbols_, vars_num_ * sizeof(uint32_t));
+    memcpy(var_slots,   var_slots_,   vars_num_ * sizeof(int));
+
+    delete [] vars_;
+    delete [] var_symbols_;
+    delete [] var_slots_;
+
+    vars_          = vars;
+    var_symbols_   = var_symbols;
+    var_slots_     = var_slots;
+    vars_capacity_ = capacity;
+}
+
+//------------------------------------------------------------------------------
+
+size_t FlatExpr::getBytes () const
+{
+    size_t node_bytes = 3 * sizeof(uint32_t) + sizeof(FlatCalcData);
+    size_t var_bytes  = sizeof(char*) + sizeof(uint32_t) + sizeof(int);
+
+    return tree_.capacity_ * node_bytes +
+           numbers_num_ * NUM_TYPE_SIZE +
+           vars_capacity_ * var_bytes +
+           tree_.size_ * NUM_TYPE_SIZE;
+}
+
+//------------------------------------------------------------------------------
+
+#define FLAT_OPERATOR(op) case op: values_[i] = calcOperator(op, left, values_[right[i]]); break;
+#define FLAT_FUNCTION(op) case op: values_[i] = calcFunction(op, values_[right[i]]);       break;
+
+NUM_TYPE FlatExpr::Execute (const NUM_TYPE* vars)
+{
+    const uint32_t*     right = tree_.right_;
+    const FlatCalcData* data  = tree_.data_;
+
+    for (size_t i = 0; i < tree_.size_; ++i)
+    {
+        switch (data[i].node_type)
+        {
+        case NODE_NUMBER:
+            values_[i] = numbers_[data[i].payload];
+            break;
+
+        case NODE_VARIABLE:
+            values_[i] = vars[data[i].payload];
+            break;
+
+        case NODE_OPERATOR:
+        {
+            /* unary minus has no left child */
+            NUM_TYPE left = (tree_.left_[i] != FLAT_NULL) ? values_[tree_.left_[i]] : NUM_TYPE(0);
+
+            switch (data[i].op_code)
+            {
+            FLAT_OPERATOR(OP_ADD)
+            FLAT_OPERATOR(OP_SUB)
+            FLAT_OPERATOR(OP_MUL)
+            FLAT_OPERATOR(OP_DIV)
+            FLAT_OPERATOR(OP_POW)
+            default: assert(0);
+            }
+            break;
+        }
+
+        case NODE_FUNCTION:
+
+            switch (data[i].op_code)
+            {
+            FLAT_FUNCTION(OP_ARCCOS)
+            FLAT_FUNCTION(OP_ARCCOSH)
+            FLAT_FUNCTION(OP_ARCCOT)
+            FLAT_FUNCTION(OP_ARCCOTH)
+            FLAT_FUNCTION(OP_ARCSIN)
+            FLAT_FUNCTION(OP_ARCSINH)
+            FLAT_FUNCTION(OP_ARCTAN)
+            FLAT_FUNCTION(OP_ARCTANH)
+            FLAT_FUNCTION(OP_COS)
+            FLAT_FUNCTION(OP_COSH)
+            FLAT_FUNCTION(OP_COT)
+            FLAT_FUNCTION(OP_COTH)
+            FLAT_FUNCTION(OP_EXP)
+            FLAT_FUNCTION(OP_LG)
+            FLAT_FUNCTION(OP_LN)
+            FLAT_FUNCTION(OP_SIN)
+            FLAT_FUNCTION(OP_SINH)
+            FLAT_FUNCTION(OP_SQRT)
+            FLAT_FUNCTION(OP_TAN)
+            FLAT_FUNCTION(OP_TANH)
+            default: assert(0);
+            }
+            break;
+
+        default: assert(0);
+        }
+    }
+
+    return values_[tree_.root_];
+}
+
+#undef FLAT_OPERATOR
+#undef FLAT_FUNCTION
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,130 @@
+/*------------------------------------------------------------------------------
+    * File:        FlatExpr.h                                                  *
+    * Description: Declaration of expression trees stored in the flat arrays   *
+    *              and their evaluation by one pass over the arrays.           *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+#ifndef FLATEXPR_H_INCLUDED
+#define FLATEXPR_H_INCLUDED
+
+#include "Bytecode.h"
+#include "../TreeLib/FlatTree.h"
+
+
+//==============================================================================
+/*------------------------------------------------------------------------------
+                   FlatExpr constants and types                                *
+*///----------------------------------------------------------------------------
+//==============================================================================
+
+
+/*
+ * Payload is the index of the number for number nodes
+ * and the index of the variable for variable nodes.
+ */
+
+struct FlatCalcData
+{
+    uint32_t payload   = 0;
+    char     op_code   = 0;
+    char     node_type = 0;
+};
+
+
+class FlatExpr
+{
+    int state_;
+
+    NUM_TYPE* values_ = nullptr;
+
+    size_t    vars_capacity_ = 0;
+
+public:
+
+    FlatTree<FlatCalcData> tree_;
+
+    NUM_TYPE* numbers_     = nullptr;
+    size_t    numbers_num_ = 0;
+
+    char**    vars_        = nullptr;
+    uint32_t* var_symbols_ = nullptr;
+    int*      var_slots_   = nullptr;
+    size_t    vars_num_    = 0;
+
+//------------------------------------------------------------------------------
+/*! @brief   Copy the expression tree to the flat arrays in post-order.
+ *
+ *  @param   tree        Equation tree
+ */
+
+    FlatExpr (Tree<CalcNodeData>& tree);
+
+//------------------------------------------------------------------------------
+/*! @brief   FlatExpr copy constructor (deleted).
+ *
+ *  @param   obj         Source flat expression
+ */
+
+    FlatExpr (const FlatExpr& obj);
+
+    FlatExpr& operator = (const FlatExpr& obj); // deleted
+
+//------------------------------------------------------------------------------
+/*! @brief   FlatExpr destructor.
+ */
+
+   ~FlatExpr ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Calculate the expression, children are always before their parents.
+ *
+ *  @param   vars        Values of the variables in the order of vars_
+ *
+ *  @return  result of the expression
+ */
+
+    NUM_TYPE Execute (const NUM_TYPE* vars);
+
+//------------------------------------------------------------------------------
+/*! @brief   Get memory taken by the expression.
+ *
+ *  @return  bytes of all arrays, the values of Execute included
+ */
+
+    size_t getBytes () const;
+
+/*------------------------------------------------------------------------------
+                   Private functions                                           *
+*///----------------------------------------------------------------------------
+
+private:
+
+//------------------------------------------------------------------------------
+/*! @brief   Find index of the variable or add it.
+ *
+ *  @param   varname     Name of the variable
+ *  @param   symbol      Symbol of the variable name
+ *  @param   slot        Slot of the variable in the calculator
+ *
+ *  @return  index of the variable
+ */
+
+    uint32_t findVar (char* varname, uint32_t symbol, int slot);
+
+//------------------------------------------------------------------------------
+/*! @brief   Double the variable table.
+ */
+
+    void GrowVars ();
+
+//------------------------------------------------------------------------------
+};
+
+//------------------------------------------------------------------------------
+
+#endif // FLATEXPR_H_INCLUDED
@@ -0,0 +1,302 @@
+/*------------------------------------------------------------------------------
+    * File:        Jit.cpp                                                     *
+    * Description: x86-64 native code generator for expression trees.         *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+#include "Jit.h"
+
+#if defined (JIT_SUPPORTED)
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+/*
+ * Generated function keeps the registers of the program in its stack frame
+ * as 16-byte [real, imag] pairs, rbp points to register 0, rbx to the
+ * variables array. Constants are placed in the page right before the code
+ * and addressed rip-relative.
+ */
+
+enum JitBases
+{
+    JIT_RIP = -1,
+    JIT_RBX =  3,
+    JIT_RBP =  5,
+};
+
+const size_t JIT_MAX_INSTRUCTION_SIZE = 64;
+const size_t JIT_CONST_SIZE           = 16;
+
+//------------------------------------------------------------------------------
+
+template <char op>
+static void jitOperator (NUM_TYPE* dst, const NUM_TYPE* left, const NUM_TYPE* right)
+{
+    *dst = calcOperator(op, *left, *right);
+}
+
+//------------------------------------------------------------------------------
+
+/* the generated call passes the left operand to every helper, functions skip it */
+template <char op>
+static void jitFunction (NUM_TYPE* dst, const NUM_TYPE* /* left */, const NUM_TYPE* right)
+{
+    *dst = calcFunction(op, *right);
+}
+
+//------------------------------------------------------------------------------
+
+#define JIT_OPERATOR(op) case op: return (const void*)&jitOperator<op>;
+#define JIT_FUNCTION(op) case op: return (const void*)&jitFunction<op>;
+
+static const void* jitHelper (char op_code)
+{
+    switch (op_code)
+    {
+    JIT_OPERATOR(OP_DIV)
+    JIT_OPERATOR(OP_POW)
+
+    JIT_FUNCTION(OP_ARCCOS)
+    JIT_FUNCTION(OP_ARCCOSH)
+    JIT_FUNCTION(OP_ARCCOT)
+    JIT_FUNCTION(OP_ARCCOTH)
+    JIT_FUNCTION(OP_ARCSIN)
+    JIT_FUNCTION(OP_ARCSINH)
+    JIT_FUNCTION(OP_ARCTAN)
+    JIT_FUNCTION(OP_ARCTANH)
+    JIT_FUNCTION(OP_COS)
+    JIT_FUNCTION(OP_COSH)
+    JIT_FUNCTION(OP_COT)
+    JIT_FUNCTION(OP_COTH)
+    JIT_FUNCTION(OP_EXP)
+    JIT_FUNCTION(OP_LG)
+    JIT_FUNCTION(OP_LN)
+    JIT_FUNCTION(OP_SIN)
+    JIT_FUNCTION(OP_SINH)
+    JIT_FUNCTION(OP_SQRT)
+    JIT_FUNCTION(OP_TAN)
+    JIT_FUNCTION(OP_TANH)
+
+    default: assert(0);
+    }
+
+    return nullptr;
+}
+
+#undef JIT_OPERATOR
+#undef JIT_FUNCTION
+
+//------------------------------------------------------------------------------
+
+Jit::Jit (Tree<CalcNodeData>& tree) :
+    state_   (CALC_OK),
+    program_ (tree)
+{
+#if defined (JIT_SUPPORTED)
+    /* nothing to generate, Execute reports the error of the program */
+    if (program_.getErrCode()) return;
+
+    size_t consts_size = JIT_CONST_SIZE * (program_.consts_num_ + 1);
+    size_t code_size   = JIT_MAX_INSTRUCTION_SIZE * (program_.size_ + 2);
+    size_t sys_page    = sysconf(_SC_PAGESIZE);
+
+    page_size_ = (consts_size + code_size + sys_page - 1) / sys_page * sys_page;
+
+    void* page = mmap(nullptr, page_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    CALC_ASSERTOK((page == MAP_FAILED), CALC_NO_MEMORY);
+
+    page_ = (unsigned char*)page;
+
+    /* sign mask for the complex multiplication goes first */
+    NUM_TYPE sign_mask = { -0.0, 0.0 };
+    Emit(&sign_mask, JIT_CONST_SIZE);
+    Emit(program_.consts_, JIT_CONST_SIZE * program_.consts_num_);
+
+    Generate();
+
+    CALC_ASSERTOK(mprotect(page_, page_size_, PROT_READ | PROT_EXEC), CALC_NOT_OK);
+
+    func_ = (JitFunc)(page_ + consts_size);
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+Jit::~Jit ()
+{
+    if (state_ != CALC_OK) return;
+
+#if defined (JIT_SUPPORTED)
+    if (page_ != nullptr) munmap(page_, page_size_);
+#endif
+
+    page_ = nullptr;
+    func_ = nullptr;
+
+    state_ = CALC_DESTRUCTED;
+}
+
+//------------------------------------------------------------------------------
+
+void Jit::Emit (const void* bytes, size_t bytes_num)
+{
+    assert(size_ + bytes_num <= page_size_);
+
+    memcpy(page_ + size_, bytes, bytes_num);
+    size_ += bytes_num;
+}
+
+//------------------------------------------------------------------------------
+
+void Jit::EmitSSE (unsigned char prefix, unsigned char opcode, unsigned xmm, int base, size_t disp)
+{
+    assert(xmm < 8);
+
+    unsigned char bytes[] = { prefix, 0x0F, opcode, 0 };
+    int32_t       disp32  = 0;
+
+    if (base == JIT_RIP)
+    {
+        bytes[3] = (unsigned char)((xmm << 3) | 5);
+        disp32   = (int32_t)((long)disp - (long)(size_ + sizeof(bytes) + sizeof(disp32)));
+    }
+    else
+    {
+        bytes[3] = (unsigned char)(0x80 | (xmm << 3) | base);
+        disp32   = (int32_t)disp;
+    }
+
+    Emit(bytes,   sizeof(bytes));
+    Emit(&disp32, sizeof(disp32));
+}
+
+//------------------------------------------------------------------------------
+
+void Jit::EmitCall (const void* helper, unsigned dst, unsigned left, unsigned right)
+{
+    int32_t disp = 0;
+
+    unsigned char lea_rdi[] = { 0x48, 0x8D, 0xBD };
+    unsigned char lea_rsi[] = { 0x48, 0x8D, 0xB5 };
+    unsigned char lea_rdx[] = { 0x48, 0x8D, 0x95 };
+
+    disp = (int32_t)(NUM_TYPE_SIZE * dst);
+    Emit(lea_rdi, sizeof(lea_rdi));
+    Emit(&disp,   sizeof(disp));
+
+    disp = (int32_t)(NUM_TYPE_SIZE * left);
+    Emit(lea_rsi, sizeof(lea_rsi));
+    Emit(&disp,   sizeof(disp));
+
+    disp = (int32_t)(NUM_TYPE_SIZE * right);
+    Emit(lea_rdx, sizeof(lea_rdx));
+    Emit(&disp,   sizeof(disp));
+
+    unsigned char mov_rax[]  = { 0x48, 0xB8 };
+    unsigned char call_rax[] = { 0xFF, 0xD0 };
+
+    Emit(mov_rax,  sizeof(mov_rax));
+    Emit(&helper,  sizeof(helper));
+    Emit(call_rax, sizeof(call_rax));
+}
+
+//------------------------------------------------------------------------------
+
+void Jit::Generate ()
+{
+    const unsigned char MOVAPD_LOAD  = 0x28;
+    const unsigned char MOVAPD_STORE = 0x29;
+    const unsigned char MOVUPD_LOAD  = 0x10;
+    const unsigned char MOVSD_LOAD   = 0x10;
+    const unsigned char ADDPD        = 0x58;
+    const unsigned char SUBPD        = 0x5C;
+    const unsigned char XORPD        = 0x57;
+
+    /* two pushes and the frame keep rsp 16-byte aligned for the calls */
+    int32_t frame = (int32_t)(NUM_TYPE_SIZE * program_.regs_num_ + 8);
+
+    unsigned char prologue[] = { 0x55,                   // push rbp
+                                 0x53,                   // push rbx
+                                 0x48, 0x81, 0xEC };     // sub  rsp, imm32
+    unsigned char frame_set[] = { 0x48, 0x89, 0xE5,      // mov  rbp, rsp
+                                  0x48, 0x89, 0xFB };    // mov  rbx, rdi
+    Emit(prologue,  sizeof(prologue));
+    Emit(&frame,    sizeof(frame));
+    Emit(frame_set, sizeof(frame_set));
+
+    for (size_t i = 0; i < program_.size_; ++i)
+    {
+        const Instruction& ins = program_.code_[i];
+
+        size_t dst   = NUM_TYPE_SIZE * ins.dst;
+        size_t left  = NUM_TYPE_SIZE * ins.left;
+        size_t right = NUM_TYPE_SIZE * ins.right;
+
+        switch (ins.code)
+        {
+        case BC_NUMBER:
+            EmitSSE(0x66, MOVAPD_LOAD,  0, JIT_RIP, JIT_CONST_SIZE * (ins.left + 1));
+            EmitSSE(0x66, MOVAPD_STORE, 0, JIT_RBP, dst);
+            break;
+
+        case BC_VARIABLE:
+            /* the variables array may be not 16-byte aligned */
+            EmitSSE(0x66, MOVUPD_LOAD,  0, JIT_RBX, left);
+            EmitSSE(0x66, MOVAPD_STORE, 0, JIT_RBP, dst);
+            break;
+
+        case OP_ADD:
+        case OP_SUB:
+            EmitSSE(0x66, MOVAPD_LOAD,  0, JIT_RBP, left);
+            EmitSSE(0x66, (ins.code == OP_ADD) ? ADDPD : SUBPD, 0, JIT_RBP, right);
+            EmitSSE(0x66, MOVAPD_STORE, 0, JIT_RBP, dst);
+            break;
+
+        case OP_MUL:
+        {
+            /* (a + bi)(c + di) = (ac - bd) + (ad + bc)i */
+            EmitSSE(0x66, MOVAPD_LOAD, 0, JIT_RBP, left);      // xmm0 = [a, b]
+            EmitSSE(0x66, MOVAPD_LOAD, 1, JIT_RBP, right);     // xmm1 = [c, d]
+
+            unsigned char mul[] = { 0x66, 0x0F, 0x28, 0xD0,          // movapd   xmm2, xmm0
+                                    0x66, 0x0F, 0x14, 0xD2,          // unpcklpd xmm2, xmm2    [a,  a ]
+                                    0x66, 0x0F, 0x15, 0xC0,          // unpckhpd xmm0, xmm0    [b,  b ]
+                                    0x66, 0x0F, 0x59, 0xD1,          // mulpd    xmm2, xmm1    [ac, ad]
+                                    0x66, 0x0F, 0xC6, 0xC9, 0x01,    // shufpd   xmm1, xmm1, 1 [d,  c ]
+                                    0x66, 0x0F, 0x59, 0xC1 };        // mulpd    xmm0, xmm1    [bd, bc]
+            Emit(mul, sizeof(mul));
+
+            EmitSSE(0x66, XORPD, 0, JIT_RIP, 0);               // xmm0 = [-bd, bc]
+
+            unsigned char add[] = { 0x66, 0x0F, 0x58, 0xD0 };        // addpd    xmm2, xmm0
+            Emit(add, sizeof(add));
+
+            EmitSSE(0x66, MOVAPD_STORE, 2, JIT_RBP, dst);
+            break;
+        }
+
+        default:
+            EmitCall(jitHelper(ins.code), ins.dst, ins.left, ins.right);
+            break;
+        }
+    }
+
+    /* result is returned in xmm0:xmm1 */
+    EmitSSE(0xF2, MOVSD_LOAD, 0, JIT_RBP, 0);
+    EmitSSE(0xF2, MOVSD_LOAD, 1, JIT_RBP, sizeof(double));
+
+    unsigned char epilogue_add[] = { 0x48, 0x81, 0xC4 };    // add rsp, imm32
+    unsigned char epilogue[]     = { 0x5B,                  // pop rbx
+                                     0x5D,                  // pop rbp
+                                     0xC3 };                // ret
+    Emit(epilogue_add, sizeof(epilogue_add));
+    Emit(&frame,       sizeof(frame));
+    Emit(epilogue,     sizeof(epilogue));
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,120 @@
+/*------------------------------------------------------------------------------
+    * File:        Jit.h                                                       *
+    * Description: Declaration of the x86-64 native code generator for        *
+    *              expression trees.                                           *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+#ifndef JIT_H_INCLUDED
+#define JIT_H_INCLUDED
+
+#include "Bytecode.h"
+
+#if defined (__x86_64__) && defined (__linux__)
+    #define JIT_SUPPORTED
+#endif
+
+
+//==============================================================================
+/*------------------------------------------------------------------------------
+                   Jit constants and types                                     *
+*///----------------------------------------------------------------------------
+//==============================================================================
+
+
+typedef NUM_TYPE (*JitFunc)(const NUM_TYPE* vars);
+
+
+class Jit
+{
+    int state_;
+
+    unsigned char* page_      = nullptr;
+    size_t         page_size_ = 0;
+    size_t         size_      = 0;
+
+public:
+
+    Program program_;
+    JitFunc func_ = nullptr;
+
+//------------------------------------------------------------------------------
+/*! @brief   Compile expression tree to the native code.
+ *
+ *  @param   tree        Equation tree
+ *
+ *  @note    func_ stays nullptr on platforms without the code generator.
+ */
+
+    Jit (Tree<CalcNodeData>& tree);
+
+//------------------------------------------------------------------------------
+/*! @brief   Jit copy constructor (deleted).
+ *
+ *  @param   obj         Source jit
+ */
+
+    Jit (const Jit& obj);
+
+    Jit& operator = (const Jit& obj); // deleted
+
+//------------------------------------------------------------------------------
+/*! @brief   Jit destructor.
+ */
+
+   ~Jit ();
+
+/*------------------------------------------------------------------------------
+                   Private functions                                           *
+*///----------------------------------------------------------------------------
+
+private:
+
+//------------------------------------------------------------------------------
+/*! @brief   Generate the machine code of the program into the page.
+ */
+
+    void Generate ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Emit bytes to the page.
+ *
+ *  @param   bytes       Bytes of the code
+ *  @param   bytes_num   Number of bytes
+ */
+
+    void Emit (const void* bytes, size_t bytes_num);
+
+//------------------------------------------------------------------------------
+/*! @brief   Emit SSE instruction with [base + disp32] or [rip + disp32] operand.
+ *
+ *  @param   prefix      Mandatory prefix (0x66, 0xF2)
+ *  @param   opcode      Second byte of the 0x0F opcode
+ *  @param   xmm         Number of xmm register
+ *  @param   base        Base register (RBP, RBX), RIP for the page constants
+ *  @param   disp        Displacement or offset of the constant in the page
+ */
+
+    void EmitSSE (unsigned char prefix, unsigned char opcode, unsigned xmm, int base, size_t disp);
+
+//------------------------------------------------------------------------------
+/*! @brief   Emit call of the helper with pointers to the registers.
+ *
+ *  @param   helper      Address of the helper
+ *  @param   dst         Register for the result
+ *  @param   left        Register of the first argument
+ *  @param   right       Register of the second argument
+ */
+
+    void EmitCall (const void* helper, unsigned dst, unsigned left, unsigned right);
+
+//------------------------------------------------------------------------------
+};
+
+//------------------------------------------------------------------------------
+
+#endif // JIT_H_INCLUDED
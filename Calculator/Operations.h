@@ -55,7 +55,7 @@ struct operation
     char* word = 0;
 };
 
-static operation op_names[] =
+constexpr operation op_names[] =
 {
     { OP_ERR      , (char*) "#ERR#"   },
     { OP_ADD      , (char*) "+"       },
@@ -87,19 +87,80 @@ static operation op_names[] =
 
 const int OP_NUM = sizeof(op_names) / sizeof(op_names[0]);
 
+/*------------------------------------------------------------------------------
+                   Function names hash                                         *
+*///----------------------------------------------------------------------------
+
+
+const size_t FUNC_HASH_SIZE = 64;
+
+struct FuncHashTable
+{
+    unsigned    seed                   = 0;
+    char        codes[FUNC_HASH_SIZE]  = {};
+    const char* words[FUNC_HASH_SIZE]  = {};
+};
+
+//------------------------------------------------------------------------------
+/*! @brief   Hash of the function name by its length, first, middle and two last letters.
+ *
+ *  @param   word        Function name
+ *  @param   len         Length of the name, not zero
+ *  @param   seed        Seed of the hash
+ *
+ *  @return  index in the table of function names
+ */
+
+constexpr size_t funcHash (const char* word, size_t len, unsigned seed)
+{
+    unsigned hsh = seed ^ (unsigned)len;
+
+    hsh = (hsh ^ (unsigned char)word[0])       * 0x01000193u;
+    hsh = (hsh ^ (unsigned char)word[len / 2]) * 0x01000193u;
+    hsh = (hsh ^ (unsigned char)word[len - 1]) * 0x01000193u;
+    hsh = (hsh ^ (unsigned char)word[(len > 1) ? len - 2 : 0]) * 0x01000193u;
+
+    return (hsh >> 16) & (FUNC_HASH_SIZE - 1);
+}
+
 //------------------------------------------------------------------------------
+/*! @brief   Find the seed without collisions for all function names.
+ *
+ *  @return  perfect hash table of function names
+ */
 
-inline int CompareOP_Names (const void* p1, const void* p2)
+constexpr FuncHashTable makeFuncHashTable ()
 {
-    assert(p1 != nullptr);
-    assert(p2 != nullptr);
-    assert(p1 != p2);
+    for (unsigned seed = 1; ; ++seed)
+    {
+        FuncHashTable table = {};
+        table.seed = seed;
+
+        bool perfect = true;
+        for (int i = 0; (i < OP_NUM) && perfect; ++i)
+        {
+            if (op_names[i].code < OP_ARCCOS) continue;
 
-    // printf("CompareOP_Names: s1(%p): %s, s2(%p): %s\n", p1, ((struct operation*)p1)->word, p2, ((struct operation*)p2)->word);
+            const char* word = op_names[i].word;
+            size_t len = 0;
+            while (word[len] != '\0') ++len;
 
-    return strcmp(((struct operation*)p1)->word, ((struct operation*)p2)->word);
+            size_t index = funcHash(word, len, seed);
+            if (table.codes[index] != 0)
+                perfect = false;
+            else
+            {
+                table.codes[index] = op_names[i].code;
+                table.words[index] = word;
+            }
+        }
+
+        if (perfect) return table;
+    }
 }
 
+constexpr FuncHashTable func_table = makeFuncHashTable();
+
 //------------------------------------------------------------------------------
 
 #endif // OPERATIONS_H_INCLUDED
\ No newline at end of file
@@ -23,6 +23,8 @@
 #include <stdio.h>
 #include <time.h>
 #include <new>
+#include <type_traits>
+#include <utility>
 
 #ifdef HASH_PROTECT
 #include "hash.h"
@@ -57,7 +59,12 @@ static int   stack_id   = 0;
         Stack<STK_TYPE> NAME ((char*)#NAME);
 
 
-template <typename TYPE>
+/*
+ * The first N slots are kept inside the stack object, the heap is used only
+ * for more values. Stack<TYPE> keeps all values on the heap.
+ */
+
+template <typename TYPE, size_t N = 0>
 class Stack
 {
 private:
@@ -66,7 +73,11 @@ private:
     size_t  capacity_ = 0;
     size_t  size_cur_ = 0;
 
-    TYPE* data_ = nullptr;
+    /* data is kept in blocks of (1 << block_shift_) slots, they never move */
+    TYPE**  blocks_      = nullptr;
+    size_t  blocks_num_  = 0;
+    size_t  blocks_cap_  = 0;
+    size_t  block_shift_ = 0;
 
     int id_ = 0;
     int errCode_;
@@ -76,6 +87,8 @@ private:
     hash_t datahash_  = 0;
 #endif // HASH_PROTECT
 
+    alignas(TYPE) unsigned char inline_[(N > 0) ? N * sizeof(TYPE) : 1];
+
 public:
 
 //------------------------------------------------------------------------------
@@ -88,7 +101,9 @@ public:
 /*! @brief   Stack constructor.
  *
  *  @param   stack_name  Stack variable name
- *  @param   capacity    Capacity of the stack
+ *  @param   capacity    Capacity of the first block of the stack on the heap
+ *
+ *  @note    Blocks are allocated only after the N inline slots.
  */
 
     Stack (char* stack_name, size_t capacity = DEFAULT_STACK_CAPACITY);
@@ -103,6 +118,16 @@ public:
 
     Stack& operator = (const Stack& obj);
 
+//------------------------------------------------------------------------------
+/*! @brief   Stack move constructor, the data is taken without copying.
+ *
+ *  @param   obj         Source stack, it stays not constructed
+ */
+
+    Stack (Stack&& obj);
+
+    Stack& operator = (Stack&& obj);
+
 //------------------------------------------------------------------------------
 /*! @brief   Stack destructor.
  */
@@ -117,7 +142,28 @@ public:
  *  @return  error code
  */
 
-    int Push (TYPE value);
+    int Push (const TYPE& value);
+
+//------------------------------------------------------------------------------
+/*! @brief   Pushing a value onto the stack by moving it.
+ *
+ *  @param   value       Value to move
+ *
+ *  @return  error code
+ */
+
+    int Push (TYPE&& value);
+
+//------------------------------------------------------------------------------
+/*! @brief   Construct a value right on the top of the stack.
+ *
+ *  @param   args        Arguments of the value constructor
+ *
+ *  @return  error code
+ */
+
+    template <typename... ARGS>
+    int Emplace (ARGS&&... args);
 
 //------------------------------------------------------------------------------
 /*! @brief   Popping from stack.
@@ -156,7 +202,7 @@ public:
     const TYPE& operator [] (size_t n) const;
 
 //------------------------------------------------------------------------------
-/*! @brief   Clean stack.
+/*! @brief   Clean stack, the capacity stays.
  */
 
     void Clean ();
@@ -172,6 +218,14 @@ public:
 
     int Dump (const char* funcname = nullptr, const char* logfile = STACK_LOGNAME);
 
+//------------------------------------------------------------------------------
+/*! @brief   Check stack and rehash all its data (if enabled), it takes O(size).
+ *
+ *  @return  error code
+ */
+
+    int Verify ();
+
 /*------------------------------------------------------------------------------
                    Private functions                                           *
 *///----------------------------------------------------------------------------
@@ -179,13 +233,73 @@ public:
 private:
 
 //------------------------------------------------------------------------------
-/*! @brief   Filling the stack data with POISON.
+/*! @brief   Construct POISON in the free slots, only if POISON_PROTECT is on.
+ *
+ *  @param   begin       First slot
+ *  @param   end         Slot after the last one
+ */
+
+    void fillPoison (size_t begin, size_t end);
+
+//------------------------------------------------------------------------------
+/*! @brief   Destroy the values in the slots.
+ *
+ *  @param   begin       First slot
+ *  @param   end         Slot after the last one
  */
 
-    void fillPoison ();
+    void Destroy (size_t begin, size_t end);
 
 //------------------------------------------------------------------------------
-/*! @brief   Increase the stack by 2 times.
+/*! @brief   Number of the slots holding constructed values, poison included.
+ *
+ *  @return  number of slots
+ */
+
+    size_t SizeConstructed () const;
+
+//------------------------------------------------------------------------------
+/*! @brief   Get the slot from its block.
+ *
+ *  @param   n           Slot
+ *
+ *  @return  reference to the slot
+ */
+
+    TYPE& Slot (size_t n) const;
+
+//------------------------------------------------------------------------------
+/*! @brief   Add one block of slots, the values are not constructed.
+ *
+ *  @return  error code
+ */
+
+    int AddBlock ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Destroy the values and free all blocks.
+ */
+
+    void FreeBlocks ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Make the blocks as in the other stack and copy its values.
+ *
+ *  @param   obj         Source stack
+ */
+
+    void CopyData (const Stack& obj);
+
+//------------------------------------------------------------------------------
+/*! @brief   Take the blocks of the other stack and move its inline values.
+ *
+ *  @param   obj         Source stack, it stays not constructed
+ */
+
+    void TakeData (Stack& obj);
+
+//------------------------------------------------------------------------------
+/*! @brief   Increase the stack by one block, values stay in place.
  *
  *  @return  error code
  */
@@ -193,7 +307,7 @@ private:
     int Expand ();
 
 //------------------------------------------------------------------------------
-/*! @brief   Check stack for problems and hash (if enabled).
+/*! @brief   Check stack for problems and hash of the stack (if enabled).
  *
  *  @return  error code
  */
@@ -220,6 +334,24 @@ private:
 
     size_t SizeForHash ();
 
+//------------------------------------------------------------------------------
+/*! @brief   Hash of the value in the slot, the data hash is the sum of them.
+ *
+ *  @param   n           Slot
+ *
+ *  @return  slot hash
+ */
+
+    hash_t SlotHash (size_t n);
+
+//------------------------------------------------------------------------------
+/*! @brief   Calculate the data hash from all values.
+ *
+ *  @return  data hash
+ */
+
+    hash_t DataHash ();
+
 #endif // HASH_PROTECT
 
 //------------------------------------------------------------------------------
@@ -8,30 +8,32 @@
     * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
     *///------------------------------------------------------------------------
 
-template <typename TYPE>
-Stack<TYPE>::Stack () : errCode_ (STACK_NOT_CONSTRUCTED) { }
+template <typename TYPE, size_t N>
+Stack<TYPE, N>::Stack () : errCode_ (STACK_NOT_CONSTRUCTED) { }
 
 //------------------------------------------------------------------------------
 
-template <typename TYPE>
-Stack<TYPE>::Stack (char* stack_name, size_t capacity) :
-    data_     (),
-    size_cur_ (0),
-    capacity_ (capacity),
+template <typename TYPE, size_t N>
+Stack<TYPE, N>::Stack (char* stack_name, size_t capacity) :
     name_     (stack_name),
     id_       (stack_id++),
     errCode_  (STACK_OK)
 {
-    STACK_ASSERTOK((capacity > MAX_CAPACITY),   STACK_WRONG_INPUT_CAPACITY_VALUE_BIG);
-    STACK_ASSERTOK((capacity == 0),             STACK_WRONG_INPUT_CAPACITY_VALUE_NIL);
-    STACK_ASSERTOK((stack_name == nullptr),     STACK_WRONG_INPUT_STACK_NAME);
-    
-    data_ = new TYPE[capacity_];
+    STACK_ASSERTOK((capacity > MAX_BLOCK_CAPACITY), STACK_WRONG_INPUT_CAPACITY_VALUE_BIG);
+    STACK_ASSERTOK((capacity == 0),                 STACK_WRONG_INPUT_CAPACITY_VALUE_NIL);
+    STACK_ASSERTOK((stack_name == nullptr),         STACK_WRONG_INPUT_STACK_NAME);
+
+    /* blocks of at least STACK_BLOCK_BYTES, the number of slots is a power of 2 */
+    while (((size_t)1 << block_shift_) * sizeof(TYPE) < STACK_BLOCK_BYTES) ++block_shift_;
+    while (((size_t)1 << block_shift_) < capacity)                         ++block_shift_;
+
+    capacity_ = N;
+    fillPoison(0, N);
 
-    fillPoison();
+    if (N == 0) STACK_ASSERTOK(AddBlock(),          STACK_NO_MEMORY);
 
 #ifdef HASH_PROTECT
-    datahash_  = hash(data_, capacity_ * sizeof(TYPE));
+    datahash_  = 0;
     stackhash_ = hash(this, SizeForHash());
 #endif // HASH_PROTECT
 
@@ -42,24 +44,15 @@ Stack<TYPE>::Stack (char* stack_name, size_t capacity) :
 
 //------------------------------------------------------------------------------
 
-template <typename TYPE>
-Stack<TYPE>::Stack (const Stack& obj) :
-    size_cur_ (obj.size_cur_),
-    capacity_ (obj.capacity_),
+template <typename TYPE, size_t N>
+Stack<TYPE, N>::Stack (const Stack& obj) :
+    name_     (obj.name_),
     id_       (stack_id++),
     errCode_  (STACK_OK)
 {
-    STACK_ASSERTOK((capacity_ > MAX_CAPACITY),  STACK_WRONG_INPUT_CAPACITY_VALUE_BIG);
-    STACK_ASSERTOK((capacity_ == 0),            STACK_WRONG_INPUT_CAPACITY_VALUE_NIL);
-
-    data_ = new TYPE[capacity_];
-
-    for (int i = 0; i < capacity_; ++i) data_[i] = obj.data_[i];
+    STACK_ASSERTOK((obj.capacity_ == 0),            STACK_WRONG_INPUT_CAPACITY_VALUE_NIL);
 
-#ifdef HASH_PROTECT
-    datahash_  = hash(data_, capacity_ * sizeof(TYPE));
-    stackhash_ = hash(this, SizeForHash());
-#endif // HASH_PROTECT
+    CopyData(obj);
 
     STACK_CHECK;
 
@@ -68,25 +61,19 @@ Stack<TYPE>::Stack (const Stack& obj) :
 
 //------------------------------------------------------------------------------
 
-template <typename TYPE>
-Stack<TYPE>& Stack<TYPE>::operator = (const Stack& obj)
+template <typename TYPE, size_t N>
+Stack<TYPE, N>& Stack<TYPE, N>::operator = (const Stack& obj)
 {
-    STACK_ASSERTOK((obj.capacity_ > MAX_CAPACITY), STACK_WRONG_INPUT_CAPACITY_VALUE_BIG);
-    STACK_ASSERTOK((obj.capacity_ == 0),           STACK_WRONG_INPUT_CAPACITY_VALUE_NIL);
+    STACK_ASSERTOK((obj.capacity_ == 0),            STACK_WRONG_INPUT_CAPACITY_VALUE_NIL);
 
-    size_cur_ = obj.size_cur_;
-    capacity_ = obj.capacity_;
-    errCode_  = STACK_OK;
+    if (this == &obj) return *this;
 
-    delete[] data_;
-    data_ = new TYPE[capacity_];
+    if ((errCode_ != STACK_NOT_CONSTRUCTED) && (errCode_ != STACK_DESTRUCTED)) FreeBlocks();
 
-    for (int i = 0; i < capacity_; ++i) copyType(data_[i], obj.data_[i]);
+    name_    = obj.name_;
+    errCode_ = STACK_OK;
 
-#ifdef HASH_PROTECT
-    datahash_  = hash(data_, capacity_ * sizeof(TYPE));
-    stackhash_ = hash(this, SizeForHash());
-#endif // HASH_PROTECT
+    CopyData(obj);
 
     STACK_CHECK;
 
@@ -97,8 +84,37 @@ Stack<TYPE>& Stack<TYPE>::operator = (const Stack& obj)
 
 //------------------------------------------------------------------------------
 
-template <typename TYPE>
-Stack<TYPE>::~Stack ()
+template <typename TYPE, size_t N>
+Stack<TYPE, N>::Stack (Stack&& obj) :
+    name_    (obj.name_),
+    id_      (obj.id_),
+    errCode_ (obj.errCode_)
+{
+    TakeData(obj);
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE, size_t N>
+Stack<TYPE, N>& Stack<TYPE, N>::operator = (Stack&& obj)
+{
+    if (this == &obj) return *this;
+
+    if ((errCode_ != STACK_NOT_CONSTRUCTED) && (errCode_ != STACK_DESTRUCTED)) FreeBlocks();
+
+    name_    = obj.name_;
+    id_      = obj.id_;
+    errCode_ = obj.errCode_;
+
+    TakeData(obj);
+
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE, size_t N>
+Stack<TYPE, N>::~Stack ()
 {
     if (errCode_ == STACK_NOT_CONSTRUCTED) return;
 
@@ -106,14 +122,7 @@ Stack<TYPE>::~Stack ()
 
     if (errCode_ != STACK_DESTRUCTED)
     {
-        size_cur_ = 0;
-
-        fillPoison();
-
-        delete [] data_;
-        data_  = nullptr;
-
-        capacity_ = 0;
+        FreeBlocks();
 
         #ifdef HASH_PROTECT
             datahash_  = 0;
@@ -130,17 +139,41 @@ Stack<TYPE>::~Stack ()
 
 //------------------------------------------------------------------------------
 
-template <typename TYPE>
-int Stack<TYPE>::Push (TYPE value)
+template <typename TYPE, size_t N>
+int Stack<TYPE, N>::Push (const TYPE& value)
+{
+    return Emplace(value);
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE, size_t N>
+int Stack<TYPE, N>::Push (TYPE&& value)
+{
+    return Emplace(std::move(value));
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE, size_t N>
+template <typename... ARGS>
+int Stack<TYPE, N>::Emplace (ARGS&&... args)
 {
     STACK_CHECK;
 
-    if (size_cur_ == capacity_ - 1) Expand();
+    if ((size_cur_ == capacity_ - 1) && Expand()) return STACK_NO_MEMORY;
+
+    TYPE* place = &Slot(size_cur_++);
 
-    data_[size_cur_++] = value;
+#ifdef POISON_PROTECT
+    /* the place holds poison, it is replaced by the new value */
+    place->~TYPE();
+#endif // POISON_PROTECT
+
+    new (place) TYPE(std::forward<ARGS>(args)...);
 
 #ifdef HASH_PROTECT
-    datahash_  = hash(data_, capacity_ * sizeof(TYPE));
+    datahash_ += SlotHash(size_cur_ - 1);
     stackhash_ = hash(this, SizeForHash());
 #endif // HASH_PROTECT
 
@@ -153,8 +186,8 @@ int Stack<TYPE>::Push (TYPE value)
 
 //------------------------------------------------------------------------------
 
-template <typename TYPE>
-TYPE Stack<TYPE>::Pop ()
+template <typename TYPE, size_t N>
+TYPE Stack<TYPE, N>::Pop ()
 {
     STACK_CHECK;
 
@@ -165,19 +198,24 @@ TYPE Stack<TYPE>::Pop ()
         DUMP_PRINT{ Dump (__FUNC_NAME__); }
 
         #ifdef HASH_PROTECT
-            datahash_  = hash(data_, capacity_ * sizeof(TYPE));
             stackhash_ = hash(this, SizeForHash());
         #endif // HASH_PROTECT
 
         return POISON<TYPE>;
     }
 
-    TYPE value = data_[--size_cur_];
+    --size_cur_;
 
-    data_[size_cur_] = POISON<TYPE>;
+#ifdef HASH_PROTECT
+    datahash_ -= SlotHash(size_cur_);
+#endif // HASH_PROTECT
+
+    TYPE value = std::move(Slot(size_cur_));
+
+    Destroy(size_cur_, size_cur_ + 1);
+    fillPoison(size_cur_, size_cur_ + 1);
 
 #ifdef HASH_PROTECT
-    datahash_  = hash(data_, capacity_ * sizeof(TYPE));
     stackhash_ = hash(this, SizeForHash());
 #endif // HASH_PROTECT
 
@@ -190,23 +228,19 @@ TYPE Stack<TYPE>::Pop ()
 
 //------------------------------------------------------------------------------
 
-template <typename TYPE>
-void Stack<TYPE>::Clean ()
+template <typename TYPE, size_t N>
+void Stack<TYPE, N>::Clean ()
 {
     STACK_CHECK;
 
-    size_cur_ = 0;
-    fillPoison();
-    delete [] data_;
-
-    capacity_ = DEFAULT_STACK_CAPACITY;
-
-    data_ = new TYPE[capacity_];
+    /* the memory stays for the next values */
+    Destroy(0, size_cur_);
+    fillPoison(0, size_cur_);
 
-    fillPoison();
+    size_cur_ = 0;
 
 #ifdef HASH_PROTECT
-    datahash_  = hash(data_, capacity_ * sizeof(TYPE));
+    datahash_  = 0;
     stackhash_ = hash(this, SizeForHash());
 #endif // HASH_PROTECT
 
@@ -217,88 +251,235 @@ void Stack<TYPE>::Clean ()
 
 //------------------------------------------------------------------------------
 
-template <typename TYPE>
-size_t Stack<TYPE>::getSize () const
+template <typename TYPE, size_t N>
+size_t Stack<TYPE, N>::getSize () const
 {
     return size_cur_;
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TYPE>
-const char* Stack<TYPE>::getName () const
+template <typename TYPE, size_t N>
+const char* Stack<TYPE, N>::getName () const
 {
     return name_;
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TYPE>
-void Stack<TYPE>::setName (char* name)
+template <typename TYPE, size_t N>
+void Stack<TYPE, N>::setName (char* name)
 {
     name_ = name;
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TYPE>
-TYPE& Stack<TYPE>::operator [] (size_t n)
+template <typename TYPE, size_t N>
+TYPE& Stack<TYPE, N>::operator [] (size_t n)
 {
-    STACK_ASSERTOK((n >= capacity_), STACK_MEM_ACCESS_VIOLATION);
+    STACK_ASSERTOK((n >= SizeConstructed()), STACK_MEM_ACCESS_VIOLATION);
 
-    return data_[n];
+    return Slot(n);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TYPE>
-const TYPE& Stack<TYPE>::operator [] (size_t n) const
+template <typename TYPE, size_t N>
+const TYPE& Stack<TYPE, N>::operator [] (size_t n) const
 {
-    STACK_ASSERTOK((n >= capacity_), STACK_MEM_ACCESS_VIOLATION);
+    STACK_ASSERTOK((n >= SizeConstructed()), STACK_MEM_ACCESS_VIOLATION);
     
-    return data_[n];
+    return Slot(n);
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TYPE>
-void Stack<TYPE>::fillPoison ()
+template <typename TYPE, size_t N>
+void Stack<TYPE, N>::fillPoison (size_t begin, size_t end)
 {
-    assert(this     != nullptr);
-    assert(data_    != nullptr);
-    assert(size_cur_ < capacity_);
+    assert(this != nullptr);
+    assert(begin <= end);
+    assert(end   <= capacity_);
 
-    for (int i = size_cur_; i < capacity_; ++i)
+#ifdef POISON_PROTECT
+    for (size_t i = begin; i < end; ++i)
     {
-        data_[i] = POISON<TYPE>;
+        new (&Slot(i)) TYPE(POISON<TYPE>);
     }
+#endif // POISON_PROTECT
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TYPE>
-int Stack<TYPE>::Expand ()
+template <typename TYPE, size_t N>
+void Stack<TYPE, N>::Destroy (size_t begin, size_t end)
 {
-    assert(this != nullptr);
+    if constexpr (not std::is_trivially_destructible<TYPE>::value)
+        for (size_t i = begin; i < end; ++i)
+            Slot(i).~TYPE();
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE, size_t N>
+size_t Stack<TYPE, N>::SizeConstructed () const
+{
+#ifdef POISON_PROTECT
+    return capacity_;
+#else
+    return size_cur_;
+#endif // POISON_PROTECT
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE, size_t N>
+inline TYPE& Stack<TYPE, N>::Slot (size_t n) const
+{
+    if constexpr (N > 0)
+    {
+        if (n < N) return ((TYPE*)inline_)[n];
+
+        n -= N;
+    }
+
+    return blocks_[n >> block_shift_][n & (((size_t)1 << block_shift_) - 1)];
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE, size_t N>
+int Stack<TYPE, N>::AddBlock ()
+{
+    if (blocks_num_ == blocks_cap_)
+    {
+        size_t blocks_cap = (blocks_cap_ == 0) ? 4 : 2 * blocks_cap_;
+
+        /* only pointers to the blocks are copied, the values stay in place */
+        TYPE** blocks = (TYPE**)realloc(blocks_, blocks_cap * sizeof(TYPE*));
+        if (blocks == nullptr) return STACK_NO_MEMORY;
 
-    capacity_ *= 2;
+        blocks_     = blocks;
+        blocks_cap_ = blocks_cap;
+    }
 
-    TYPE* temp = temp = new TYPE[capacity_];
+    size_t block_size = (size_t)1 << block_shift_;
 
-    memcpy(temp, (char*)data_, capacity_ * sizeof(TYPE) / 2);
+    TYPE* block = (TYPE*)::operator new(block_size * sizeof(TYPE), std::nothrow);
+    if (block == nullptr) return STACK_NO_MEMORY;
 
-    delete [] data_;
-    data_ = temp;
+    blocks_[blocks_num_++] = block;
+    capacity_ += block_size;
 
-    fillPoison();
+    fillPoison(capacity_ - block_size, capacity_);
 
     return STACK_OK;
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TYPE>
-int Stack<TYPE>::Dump (const char* funcname, const char* logfile)
+template <typename TYPE, size_t N>
+void Stack<TYPE, N>::FreeBlocks ()
+{
+    Destroy(0, SizeConstructed());
+
+    for (size_t i = 0; i < blocks_num_; ++i)
+        ::operator delete(blocks_[i]);
+
+    free(blocks_);
+
+    blocks_     = nullptr;
+    blocks_num_ = 0;
+    blocks_cap_ = 0;
+    capacity_   = 0;
+    size_cur_   = 0;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE, size_t N>
+void Stack<TYPE, N>::TakeData (Stack& obj)
+{
+    capacity_    = obj.capacity_;
+    size_cur_    = obj.size_cur_;
+    blocks_      = obj.blocks_;
+    blocks_num_  = obj.blocks_num_;
+    blocks_cap_  = obj.blocks_cap_;
+    block_shift_ = obj.block_shift_;
+
+    if constexpr (N > 0)
+    {
+        size_t inline_num = (obj.SizeConstructed() < N) ? obj.SizeConstructed() : N;
+
+        for (size_t i = 0; i < inline_num; ++i)
+        {
+            new (&Slot(i)) TYPE(std::move(obj.Slot(i)));
+            obj.Slot(i).~TYPE();
+        }
+    }
+
+    obj.blocks_     = nullptr;
+    obj.blocks_num_ = 0;
+    obj.blocks_cap_ = 0;
+    obj.capacity_   = 0;
+    obj.size_cur_   = 0;
+    obj.errCode_    = STACK_NOT_CONSTRUCTED;
+
+#ifdef HASH_PROTECT
+    /* inline values are at other addresses now, their bytes may differ */
+    datahash_  = (N > 0) ? DataHash() : obj.datahash_;
+    stackhash_ = hash(this, SizeForHash());
+#endif // HASH_PROTECT
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE, size_t N>
+void Stack<TYPE, N>::CopyData (const Stack& obj)
+{
+    blocks_      = nullptr;
+    blocks_num_  = 0;
+    blocks_cap_  = 0;
+    block_shift_ = obj.block_shift_;
+    capacity_    = N;
+    size_cur_    = 0;
+
+    fillPoison(0, N);
+
+    while (capacity_ < obj.capacity_)
+        STACK_ASSERTOK(AddBlock(), STACK_NO_MEMORY);
+
+    for (; size_cur_ < obj.size_cur_; ++size_cur_)
+    {
+#ifdef POISON_PROTECT
+        Slot(size_cur_).~TYPE();
+#endif // POISON_PROTECT
+
+        new (&Slot(size_cur_)) TYPE(obj.Slot(size_cur_));
+    }
+
+#ifdef HASH_PROTECT
+    datahash_  = DataHash();
+    stackhash_ = hash(this, SizeForHash());
+#endif // HASH_PROTECT
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE, size_t N>
+int Stack<TYPE, N>::Expand ()
+{
+    assert(this != nullptr);
+
+    /* one more block, the values never move */
+    return AddBlock();
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE, size_t N>
+int Stack<TYPE, N>::Dump (const char* funcname, const char* logfile)
 {
     const size_t linelen = 80;
     char divline[linelen + 1] = "********************************************************************************";
@@ -359,20 +540,21 @@ int Stack<TYPE>::Dump (const char* funcname, const char* logfile)
     if ((errCode_ != STACK_OK) && (errCode_ != STACK_EMPTY_STACK) && (errCode_ != STACK_NO_MEMORY))
     {
         fprintf(fp, "\tTrue stack hash    = " HASH_PRINT_FORMAT "\n",   hash(this, SizeForHash()));
-        fprintf(fp, "\tTrue data hash     = " HASH_PRINT_FORMAT "\n\n", hash(data_, capacity_ * sizeof(TYPE)));
+        fprintf(fp, "\tTrue data hash     = " HASH_PRINT_FORMAT "\n\n", DataHash());
     }
 #endif // HASH_PROTECT
 
-    fprintf(fp, "\tData [" PRINT_PTR "]\n", data_);
+    fprintf(fp, "\tInline slots       = %lu\n", N);
+    fprintf(fp, "\tBlocks [" PRINT_PTR "] = %lu of %lu slots\n\n", blocks_, blocks_num_, (size_t)1 << block_shift_);
 
     fprintf(fp, "\t\t{\n");
 
-    for (int i = 0; i < capacity_; i++)
+    for (size_t i = 0; i < SizeConstructed(); i++)
     {
-        char ispois = isPOISON(data_[i]);
+        char ispois = isPOISON(Slot(i));
 
-        fprintf(fp, "\t\t%s[%d]: [", (ispois) ? " ": "*", i);
-        TypePrint(fp, data_[i]);
+        fprintf(fp, "\t\t%s[%zu]: [", (ispois) ? " ": "*", i);
+        TypePrint(fp, Slot(i));
         fprintf(fp, "]%s\n", (ispois) ? " (POISON)": "");
     }
 
@@ -388,8 +570,8 @@ int Stack<TYPE>::Dump (const char* funcname, const char* logfile)
 
 //------------------------------------------------------------------------------
 
-template <typename TYPE>
-int Stack<TYPE>::Check ()
+template <typename TYPE, size_t N>
+int Stack<TYPE, N>::Check ()
 {
     if (this == nullptr)
     {
@@ -413,7 +595,7 @@ int Stack<TYPE>::Check ()
     }
 #endif // HASH_PROTECT
 
-    else if (data_ == nullptr)
+    else if ((N == 0) && (blocks_ == nullptr))
     {
         errCode_ = STACK_NULL_DATA_PTR;
     }
@@ -423,35 +605,47 @@ int Stack<TYPE>::Check ()
         errCode_ = STACK_SIZE_BIGGER_CAPACITY;
     }
 
-    else if ((capacity_ == 0) || (capacity_ > MAX_CAPACITY))
+    else if ((capacity_ == 0) || (capacity_ != N + (blocks_num_ << block_shift_)))
     {
         errCode_ = STACK_CAPACITY_WRONG_VALUE;
     }
 
-    else if (! isPOISON(data_[size_cur_]))
+#ifdef POISON_PROTECT
+    else if (! isPOISON(Slot(size_cur_)))
     {
         errCode_ = STACK_WRONG_CUR_SIZE;
     }
+#endif // POISON_PROTECT
 
-#ifdef HASH_PROTECT
-    else if (datahash_ != hash(data_, capacity_ * sizeof(TYPE)))
+    else
     {
-        errCode_ = STACK_INCORRECT_HASH;
+        errCode_ = STACK_OK;
     }
-#endif // HASH_PROTECT
 
-    else
+    return errCode_;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE, size_t N>
+int Stack<TYPE, N>::Verify ()
+{
+    if (Check()) return errCode_;
+
+#ifdef HASH_PROTECT
+    if (datahash_ != DataHash())
     {
-        errCode_ = STACK_OK;
+        errCode_ = STACK_INCORRECT_HASH;
     }
+#endif // HASH_PROTECT
 
     return errCode_;
 }
 
 //------------------------------------------------------------------------------
 
-template <typename TYPE>
-void Stack<TYPE>::ErrorPrint (FILE* fp)
+template <typename TYPE, size_t N>
+void Stack<TYPE, N>::ErrorPrint (FILE* fp)
 {
     assert(fp != nullptr);
 
@@ -504,8 +698,8 @@ static void printError (const char* logname, const char* file, int line, const c
 
 #ifdef HASH_PROTECT
 
-template <typename TYPE>
-size_t Stack<TYPE>::SizeForHash ()
+template <typename TYPE, size_t N>
+size_t Stack<TYPE, N>::SizeForHash ()
 {
     assert(this != nullptr);
 
@@ -514,12 +708,36 @@ size_t Stack<TYPE>::SizeForHash ()
     size += sizeof(name_);
     size += sizeof(capacity_);
     size += sizeof(size_cur_);
-    size += sizeof(data_);
+    size += sizeof(blocks_);
+    size += sizeof(blocks_num_);
+    size += sizeof(blocks_cap_);
+    size += sizeof(block_shift_);
     size += sizeof(id_);
 
     return size;
 }
 
+//------------------------------------------------------------------------------
+
+template <typename TYPE, size_t N>
+hash_t Stack<TYPE, N>::SlotHash (size_t n)
+{
+    return hash_slot(&Slot(n), sizeof(TYPE), n);
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE, size_t N>
+hash_t Stack<TYPE, N>::DataHash ()
+{
+    hash_t datahash = 0;
+
+    for (size_t i = 0; i < size_cur_; ++i)
+        datahash += SlotHash(i);
+
+    return datahash;
+}
+
 #endif // HASH_PROTECT
 
 //------------------------------------------------------------------------------
@@ -50,10 +50,17 @@
 
 #endif // NO_HASH
 
+#ifndef NO_POISON
+
+    #define POISON_PROTECT
+
+#endif // NO_POISON
+
 
 char const * const STACK_LOGNAME = "stack.log";
 
-constexpr size_t MAX_CAPACITY  = 100000;
+constexpr size_t MAX_BLOCK_CAPACITY = 1 << 20; // capacity given to the constructor
+constexpr size_t STACK_BLOCK_BYTES  = 4096;    // smallest block of the stack data
 
 
 enum StackErrors
@@ -10,6 +10,21 @@
     *///------------------------------------------------------------------------
 
 #include "hash.h"
+#include <algorithm>
+#include <stdint.h>
+
+#if defined (__AVX2__)
+    #include <immintrin.h>
+#elif defined (__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+static const hash_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+static const hash_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+static const hash_t PRIME_3 = 0x165667B19E3779F9ULL;
+static const hash_t PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+
+static const size_t LANES_NUM = STRIPE_SIZE / sizeof(hash_t);
 
 //------------------------------------------------------------------------------
 
@@ -20,67 +35,154 @@ int bit_rotate (void* buf, size_t size, int dir)
     if ((size == 0) || (dir == 0))
         return 0;
 
-    char* carry_bits = (char*)calloc(size, 1);
-    if (carry_bits == nullptr)
-        return 0;
+    unsigned char* bytes = (unsigned char*)buf;
+    size_t         bits  = size * 8;
+
+    /* byte 0 is the lowest, turning left is turning right by the rest of bits */
+    size_t shift = (dir > 0) ? (size_t)dir % bits : (bits - (size_t)(-(long long)dir) % bits) % bits;
 
-    if (dir > 0)
+    std::rotate(bytes, bytes + shift / 8, bytes + size);
+
+    unsigned bit_shift = shift % 8;
+    if (bit_shift != 0)
     {
-        dir = dir % (size * 8);
-        for (int i = 0; i < dir; ++i)
-        {
-            for (int byte_i = 0; byte_i < size; ++byte_i)
-            {
-                carry_bits[byte_i] = *((char*)buf + byte_i) & 1;
-            }
+        unsigned char first = bytes[0];
+
+        for (size_t byte_i = 0; byte_i < size - 1; ++byte_i)
+            bytes[byte_i] = (bytes[byte_i] >> bit_shift) | (bytes[byte_i + 1] << (8 - bit_shift));
+
+        bytes[size - 1] = (bytes[size - 1] >> bit_shift) | (first << (8 - bit_shift));
+    }
 
-            for (int byte_i = 0; byte_i < size - 1; ++byte_i)
-            {
-                char byte = *((char*)buf + byte_i);
-                byte = byte >> 1;
-                byte = (byte & 127) | (128 * carry_bits[byte_i + 1]);
+    return 1;
+}
 
-                ((char*)buf)[byte_i] = byte;
-            }
+//------------------------------------------------------------------------------
 
-            char byte = *((char*)buf + size - 1);
-            byte = byte >> 1;
-            byte = (byte & 127) | (128 * carry_bits[0]);
+/*
+ * 64-bit keys for the lanes, made from Keys once. Stripe i of a block uses
+ * the keys from i, so the same bytes in other stripes give other sums.
+ */
 
-            ((char*)buf)[size - 1] = byte;
-        }
+struct StripeKeys
+{
+    hash_t key[STRIPES_NUM + LANES_NUM];
+
+    StripeKeys ()
+    {
+        for (size_t i = 0; i < STRIPES_NUM + LANES_NUM; ++i)
+            key[i] = ((hash_t)Keys[i % KEYS_NUM] << 32 | Keys[(i + 5) % KEYS_NUM]) * PRIME_1;
+    }
+};
+
+/* made on the first call, so hash works from constructors of static objects too */
+static const hash_t* getStripeKeys ()
+{
+    static const StripeKeys stripe_keys;
+
+    return stripe_keys.key;
+}
+
+//------------------------------------------------------------------------------
+
+static inline hash_t load64 (const unsigned char* ptr)
+{
+    hash_t value = 0;
+    memcpy(&value, ptr, sizeof(value));
+
+    return value;
+}
+
+//------------------------------------------------------------------------------
+
+static inline hash_t avalanche (hash_t hsh)
+{
+    hsh ^= hsh >> 33;
+    hsh *= PRIME_2;
+    hsh ^= hsh >> 29;
+    hsh *= PRIME_3;
+    hsh ^= hsh >> 32;
+
+    return hsh;
+}
+
+//------------------------------------------------------------------------------
+
+/*
+ * Every lane takes the product of the halves of (data ^ key) and the data
+ * of the neighbour lane. SIMD versions give the same sums as the plain one.
+ */
+
+static void accumulate (hash_t* acc, const unsigned char* ptr, size_t stripes_num)
+{
+    const hash_t* key = getStripeKeys();
+
+#if defined (__AVX2__)
+
+    __m256i sum = _mm256_loadu_si256((const __m256i*)acc);
+
+    for (size_t i = 0; i < stripes_num; ++i, ptr += STRIPE_SIZE)
+    {
+        __m256i data     = _mm256_loadu_si256((const __m256i*)ptr);
+        __m256i data_key = _mm256_xor_si256(data, _mm256_loadu_si256((const __m256i*)(key + i)));
+
+        __m256i product  = _mm256_mul_epu32(data_key, _mm256_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+        __m256i swapped  = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+
+        sum = _mm256_add_epi64(sum, _mm256_add_epi64(product, swapped));
     }
-    else
+
+    _mm256_storeu_si256((__m256i*)acc, sum);
+
+#elif defined (__SSE2__)
+
+    __m128i sum_lo = _mm_loadu_si128((const __m128i*)acc);
+    __m128i sum_hi = _mm_loadu_si128((const __m128i*)(acc + 2));
+
+    for (size_t i = 0; i < stripes_num; ++i, ptr += STRIPE_SIZE)
     {
-        dir = -dir % (size * 8);
+        __m128i data_lo     = _mm_loadu_si128((const __m128i*)ptr);
+        __m128i data_hi     = _mm_loadu_si128((const __m128i*)(ptr + 16));
+        __m128i data_key_lo = _mm_xor_si128(data_lo, _mm_loadu_si128((const __m128i*)(key + i)));
+        __m128i data_key_hi = _mm_xor_si128(data_hi, _mm_loadu_si128((const __m128i*)(key + i + 2)));
 
-        for (int i = 0; i < dir; ++i)
-        {
-            for (int byte_i = 0; byte_i < size; ++byte_i)
-            {
-                carry_bits[byte_i] = *((char*)buf + byte_i) & 128;
-            }
+        __m128i product_lo  = _mm_mul_epu32(data_key_lo, _mm_shuffle_epi32(data_key_lo, _MM_SHUFFLE(0, 3, 0, 1)));
+        __m128i product_hi  = _mm_mul_epu32(data_key_hi, _mm_shuffle_epi32(data_key_hi, _MM_SHUFFLE(0, 3, 0, 1)));
 
-            for (int byte_i = size - 1; byte_i > 0; --byte_i)
-            {
-                char byte = *((char*)buf + byte_i);
-                byte = byte << 1;
-                byte = (byte & 254) | (carry_bits[byte_i - 1] / 128);
+        sum_lo = _mm_add_epi64(sum_lo, _mm_add_epi64(product_lo, _mm_shuffle_epi32(data_lo, _MM_SHUFFLE(1, 0, 3, 2))));
+        sum_hi = _mm_add_epi64(sum_hi, _mm_add_epi64(product_hi, _mm_shuffle_epi32(data_hi, _MM_SHUFFLE(1, 0, 3, 2))));
+    }
 
-                ((char*)buf)[byte_i] = byte;
-            }
+    _mm_storeu_si128((__m128i*)acc,       sum_lo);
+    _mm_storeu_si128((__m128i*)(acc + 2), sum_hi);
 
-            char byte = *((char*)buf);
-            byte = byte << 1;
-            byte = (byte & 254) | (carry_bits[size - 1] / 128);
+#else
+
+    for (size_t i = 0; i < stripes_num; ++i, ptr += STRIPE_SIZE)
+    {
+        for (size_t lane = 0; lane < LANES_NUM; ++lane)
+        {
+            hash_t data     = load64(ptr + lane * sizeof(hash_t));
+            hash_t data_key = data ^ key[i + lane];
 
-            ((char*)buf)[0] = byte;
+            acc[lane ^ 1] += data;
+            acc[lane]     += (data_key & 0xFFFFFFFF) * (data_key >> 32);
         }
     }
 
-    free(carry_bits);
+#endif
+}
 
-    return 1;
+//------------------------------------------------------------------------------
+
+static void scramble (hash_t* acc)
+{
+    for (size_t lane = 0; lane < LANES_NUM; ++lane)
+    {
+        acc[lane] ^= acc[lane] >> 47;
+        acc[lane] ^= getStripeKeys()[STRIPES_NUM + lane];
+        acc[lane] *= PRIME_1;
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -89,40 +191,59 @@ hash_t hash (void* buf, size_t size)
 {
     assert(buf != nullptr);
 
-    size_t main_size = (size / BLOCK_SIZE) * BLOCK_SIZE + BLOCK_SIZE;
-    size_t half_size = main_size / 2;
+    const unsigned char* ptr = (const unsigned char*)buf;
 
-    char* buf_main = (char*)calloc(main_size, 1);
-    if (buf_main == nullptr)
-        return 0;
+    hash_t acc[LANES_NUM] = { PRIME_1, PRIME_2, PRIME_3, PRIME_4 };
 
-    memcpy(buf_main, buf, size);
-    hash_t hsh = (hash_t)(Keys[size % KEYS_NUM]);
+    const size_t block_size = STRIPE_SIZE * STRIPES_NUM;
 
-    for (size_t byte_i = 0; byte_i < half_size; ++byte_i)
+    size_t rest = size;
+    for (; rest >= block_size; rest -= block_size, ptr += block_size)
     {
-        char b1 = *((char*)buf_main + byte_i);
-        char b2 = *((char*)buf_main + byte_i + half_size);
-
-        char p1 = b1;
-        char p2 = b2;
+        accumulate(acc, ptr, STRIPES_NUM);
+        scramble(acc);
+    }
 
-        bit_rotate(&p1, 1, 1 + byte_i);
-        bit_rotate(&p2, 1, 1 - byte_i);
+    accumulate(acc, ptr, rest / STRIPE_SIZE);
+    ptr  += rest / STRIPE_SIZE * STRIPE_SIZE;
+    rest %= STRIPE_SIZE;
 
-        int q1 = b2 ^ p1 ^ Keys[ byte_i      % KEYS_NUM] + b1;
-        int q2 = b1 ^ p2 ^ Keys[(byte_i + 1) % KEYS_NUM] + b2;
+    /*
+     * The tail is taken with the end of the previous stripe if there is one,
+     * else it is padded by zeros. The size tells them from real bytes.
+     */
+    if (rest != 0)
+    {
+        if (size >= STRIPE_SIZE)
+            accumulate(acc, ptr + rest - STRIPE_SIZE, 1);
+        else
+        {
+            unsigned char last[STRIPE_SIZE] = {};
+            memcpy(last, ptr, rest);
 
-        char d1 = *((char*)buf_main - 1 - byte_i + main_size);
-        char d2 = *((char*)buf_main - 1 - byte_i + half_size);
+            accumulate(acc, last, 1);
+        }
+    }
 
-        hsh = hsh * (q1*d2 + q2*d1) + hsh ^ (q1*d1 + q2*d2) + q1 + q2 + b1 + b2;
+    hash_t hsh = (hash_t)size * PRIME_1 + Keys[size % KEYS_NUM];
 
-        bit_rotate(&hsh, sizeof(hsh), 3);
+    for (size_t lane = 0; lane < LANES_NUM; ++lane)
+    {
+        hsh ^= (acc[lane] ^ (acc[lane] >> 31)) * PRIME_2;
+        hsh  = ((hsh << 27) | (hsh >> 37)) * PRIME_1 + PRIME_4;
     }
-    free(buf_main);
 
-    return hsh;
+    return avalanche(hsh);
+}
+
+//------------------------------------------------------------------------------
+
+hash_t hash_slot (void* buf, size_t size, size_t index)
+{
+    assert(buf != nullptr);
+
+    /* index is mixed in, so swapped elements change the sum */
+    return avalanche(hash(buf, size) + (hash_t)index * PRIME_1);
 }
 
 //------------------------------------------------------------------------------
@@ -30,8 +30,9 @@ typedef unsigned long long hash_t;
 
 #define HASH_PRINT_FORMAT "0x%016llX"
 
-static const size_t BLOCK_SIZE = 64;
-static const size_t KEYS_NUM   = 16;
+static const size_t STRIPE_SIZE = 32; // bytes hashed per step
+static const size_t STRIPES_NUM = 16; // steps between scrambles of the lanes
+static const size_t KEYS_NUM    = 16;
 
 static const size_t Keys[KEYS_NUM] =
 {
@@ -42,7 +43,7 @@ static const size_t Keys[KEYS_NUM] =
 };
 
 //------------------------------------------------------------------------------
-/*! @brief   Circular shift of bits anywhere in any length.
+/*! @brief   Circular shift of bits anywhere in any length, without allocations.
  *
  *  @param   buf  Start of memory for turning round
  *  @param   size Size of memory for turning round
@@ -54,16 +55,31 @@ static const size_t Keys[KEYS_NUM] =
 int bit_rotate (void* buf, size_t size, int dir);
 
 //------------------------------------------------------------------------------
-/*! @brief   Hash counting.
+/*! @brief   Hash counting, STRIPE_SIZE bytes per step (SIMD if available),
+ *           without allocations.
  *
  *  @param   buf  Start of memory to be hashable
  *  @param   size Size of memory to be hashable
  *
- *  @return  0 if error, else hash
+ *  @return  hash
  */
 
 hash_t hash (void* buf, size_t size);
 
+//------------------------------------------------------------------------------
+/*! @brief   Hash of one element of an array. Element hashes can be summed
+ *           to the hash of the array, so one element can be added or removed
+ *           without rehashing the others.
+ *
+ *  @param   buf   Start of the element
+ *  @param   size  Size of the element
+ *  @param   index Index of the element in the array
+ *
+ *  @return  hash
+ */
+
+hash_t hash_slot (void* buf, size_t size, size_t index);
+
 //------------------------------------------------------------------------------
 
 #endif // HASH_H_INCLUDED
@@ -10,14 +10,26 @@
 
 #include "StringLib.h"
 
+#if defined (__linux__)
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+#if defined (__AVX2__)
+    #include <immintrin.h>
+#elif defined (__SSE2__)
+    #include <emmintrin.h>
+#endif
+
 //------------------------------------------------------------------------------
 
 Text::Text () : state_ (STR_TEXT_NOT_CONSTRUCTED) {}
 
 //------------------------------------------------------------------------------
 
-Text::Text (const char* filename) :
-    state_ (STR_OK)
+Text::Text (const char* filename, int mode) :
+    state_ (STR_OK),
+    mode_  (mode)
 {
     STR_ASSERTOK((filename == nullptr), STR_NULL_INPUT_TEXT_FILE_NAME);
 
@@ -32,6 +44,16 @@ Text::Text (const char* filename) :
     size_ = CountSize(fp);
     STR_ASSERTOK((size_ == 0), STR_NO_SYMB);
 
+    if (mode_ == TEXT_MAP)
+    {
+        text_ = MapText(fp, size_, map_size_);
+        STR_ASSERTOK((text_ == nullptr), STR_NO_MEMORY);
+
+        fclose(fp);
+
+        return;
+    }
+
     text_ = GetText(fp, size_);
     STR_ASSERTOK((text_ == nullptr), STR_NO_MEMORY);
 
@@ -72,14 +94,25 @@ Text::~Text ()
 
     if ((state_ != STR_TEXT_DESTRUCTED) && (state_ != STR_TEXT_NOT_CONSTRUCTED))
     {
-        if (num_ != 0)
+        /* mapped text keeps the buffer of lines even when no lines are given */
+        if ((num_ != 0) || (mode_ == TEXT_MAP))
         {
-            assert(lines_ != nullptr);
+            assert((lines_ != nullptr) || (mode_ == TEXT_MAP));
             free(lines_);
             lines_ = nullptr;
             num_   = 0;
         }
 
+        if (map_size_ != 0)
+        {
+#if defined (__linux__)
+            munmap(text_, map_size_);
+#endif
+            text_     = nullptr;
+            size_     = 0;
+            map_size_ = 0;
+        }
+        else
         if (size_ != 0)
         {
             assert(text_ != nullptr);
@@ -124,6 +157,69 @@ int Text::Expand (size_t line_len)
 
 //------------------------------------------------------------------------------
 
+size_t Text::NextLines (size_t lines_max)
+{
+    STR_ASSERTOK((this == nullptr), STR_NULL_INPUT_TEXT_PTR);
+    STR_ASSERTOK(state_, state_);
+    STR_ASSERTOK((mode_ != TEXT_MAP), STR_TEXT_NOT_MAPPED);
+    STR_ASSERTOK((lines_max == 0),    STR_NULL_INPUT_TEXT_LINES_NUM);
+
+    if (lines_cap_ < lines_max)
+    {
+        free(lines_);
+        lines_ = (Line*)calloc(lines_max + 2, sizeof(Line));
+        STR_ASSERTOK((lines_ == nullptr), STR_NO_MEMORY);
+
+        lines_cap_ = lines_max;
+    }
+
+#if defined (__linux__)
+    /* lines given before are not used any more, their pages are dropped */
+    if (map_size_ != 0)
+    {
+        size_t page_size = sysconf(_SC_PAGESIZE);
+        size_t used      = next_ / page_size * page_size;
+
+        if (used > released_)
+        {
+            madvise(text_ + released_, used - released_, MADV_DONTNEED);
+            released_ = used;
+        }
+    }
+#endif
+
+    char* text = text_ + next_;
+    char* end  = text_ + size_;
+
+    num_ = 0;
+    while ((num_ < lines_max) && (text < end))
+    {
+        while (isspace(*text) && (*text != '\n'))
+            ++text;
+
+        /* spaces after the last new line are not a line */
+        if (text == end) break;
+
+        char* start = text;
+        text = FindNewLine(text, end);
+
+        /* the byte after the text is already zero */
+        if (text != end) *text = '\0';
+
+        lines_[num_].str = start;
+        lines_[num_].len = text - start;
+        ++num_;
+
+        ++text;
+    }
+
+    next_ = (text < end) ? text - text_ : size_;
+
+    return num_;
+}
+
+//------------------------------------------------------------------------------
+
 BinCode::BinCode () : state_ (STR_BINCODE_NOT_CONSTRUCTED) {}
 
 //------------------------------------------------------------------------------
@@ -143,7 +239,7 @@ BinCode::BinCode (size_t size) :
 
 //------------------------------------------------------------------------------
 
-BinCode::BinCode (const char* filename) :
+BinCode::BinCode (const char* filename, int mode) :
     state_ (STR_OK)
 {
     STR_ASSERTOK((this == nullptr),     STR_NULL_INPUT_BINCODE_PTR);
@@ -160,7 +256,7 @@ BinCode::BinCode (const char* filename) :
     size_ = CountSize(fp);
     STR_ASSERTOK((size_ == 0) , STR_NO_MEMORY);
 
-    data_ = GetText(fp, size_);
+    data_ = (mode == TEXT_MAP) ? MapText(fp, size_, map_size_) : GetText(fp, size_);
     STR_ASSERTOK((data_ == nullptr) , STR_NO_MEMORY);
 
     fclose(fp);
@@ -176,6 +272,16 @@ BinCode::~BinCode ()
 
     if ((state_ != STR_BINCODE_DESTRUCTED) && (state_ != STR_BINCODE_NOT_CONSTRUCTED))
     {
+        if (map_size_ != 0)
+        {
+#if defined (__linux__)
+            munmap(data_, map_size_);
+#endif
+            map_size_ = 0;
+            ptr_      = 0;
+            size_     = 0;
+        }
+        else
         if (size_ != 0)
         {
             free(data_);
@@ -211,6 +317,47 @@ int BinCode::Expand ()
 
 //------------------------------------------------------------------------------
 
+int BinCode::Put (const void* src, size_t len)
+{
+    STR_ASSERTOK((this == nullptr), STR_NULL_INPUT_BINCODE_PTR);
+    STR_ASSERTOK(state_, state_);
+    assert((src != nullptr) || (len == 0));
+    assert(map_size_ == 0);
+
+    while (ptr_ + len > size_)
+    {
+        int err = Expand();
+        if (err) return err;
+    }
+
+    if (len != 0) memcpy(data_ + ptr_, src, len);
+    ptr_ += len;
+
+    return STR_OK;
+}
+
+//------------------------------------------------------------------------------
+
+int BinCode::Write (const char* filename)
+{
+    STR_ASSERTOK((this == nullptr), STR_NULL_INPUT_BINCODE_PTR);
+    STR_ASSERTOK(state_, state_);
+    assert(filename != nullptr);
+
+    FILE* fp = fopen(filename, "wb");
+    if (fp == nullptr)
+        return STR_BINCODE_WRITE_ERROR;
+
+    size_t written = fwrite(data_, 1, ptr_, fp);
+
+    if ((fclose(fp) != 0) || (written != ptr_))
+        return STR_BINCODE_WRITE_ERROR;
+
+    return STR_OK;
+}
+
+//------------------------------------------------------------------------------
+
 char* GetFileName (int argc, char** argv)
 {
     assert(argc);
@@ -272,7 +419,91 @@ char* GetText (FILE* fp, size_t len)
     if (text == nullptr)
         return nullptr;
 
-    int err = fread(text, 1, len, fp);
+    /* a short read is an error, the callers take nullptr as no text */
+    if (fread(text, 1, len, fp) != len)
+    {
+        free(text);
+        return nullptr;
+    }
+
+    return text;
+}
+
+//------------------------------------------------------------------------------
+
+char* MapText (FILE* fp, size_t len, size_t& map_size)
+{
+    assert(fp != nullptr);
+    assert(len);
+
+    map_size = 0;
+
+#if defined (__linux__)
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    size_t size      = (len + page_size - 1) / page_size * page_size;
+
+    /* the kernel places the file itself, so its pages are dropped well after reading */
+    char* text = (char*)mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(fp), 0);
+    if (text == MAP_FAILED)
+        return nullptr;
+
+    /* the rest of the last page is zero, a full last page is followed by a zero page */
+    if (size == len)
+    {
+        void* zero = MAP_FAILED;
+#if defined (MAP_FIXED_NOREPLACE)
+        zero = mmap(text + size, page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+#endif
+        if (zero != text + size)
+        {
+            if (zero != MAP_FAILED) munmap(zero, page_size);
+            munmap(text, size);
+
+            return GetText(fp, len);
+        }
+
+        size += page_size;
+    }
+
+    madvise(text, len, MADV_SEQUENTIAL);
+
+    map_size = size;
+
+    return text;
+#else
+    return GetText(fp, len);
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+char* FindNewLine (char* text, char* end)
+{
+    assert(text != nullptr);
+    assert(end  != nullptr);
+
+#if defined (__AVX2__)
+    const __m256i newline = _mm256_set1_epi8('\n');
+
+    for (; end - text >= 32; text += 32)
+    {
+        unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)text), newline));
+        if (mask != 0)
+            return text + __builtin_ctz(mask);
+    }
+#elif defined (__SSE2__)
+    const __m128i newline = _mm_set1_epi8('\n');
+
+    for (; end - text >= 16; text += 16)
+    {
+        unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)text), newline));
+        if (mask != 0)
+            return text + __builtin_ctz(mask);
+    }
+#endif
+
+    while ((text < end) && (*text != '\n'))
+        ++text;
 
     return text;
 }
@@ -284,17 +515,14 @@ size_t GetLineNum (char* text, size_t len)
     assert(text != nullptr);
     assert(len);
 
-    char* start = text;
+    char* end = text + len;
 
-    size_t num = 0;
+    size_t num = 1;
 
-    while (text - start <= len)
+    while ((text = FindNewLine(text, end)) != end)
     {
         ++num;
-
-        text = strchr(text, '\n') + 1;
-        if (text == (char*)1)
-            break;
+        ++text;
     }
 
     return num;
@@ -64,6 +64,8 @@ enum StringErrors
     STR_BINCODE_NOT_CONSTRUCTED                                        ,
     STR_TEXT_DESTRUCTED                                                ,
     STR_TEXT_NOT_CONSTRUCTED                                           ,
+    STR_TEXT_NOT_MAPPED                                                ,
+    STR_BINCODE_WRITE_ERROR                                            ,
 };
 
 char const * const str_errstr[] =
@@ -85,6 +87,8 @@ char const * const str_errstr[] =
     "BinCode did not constructed, operation is impossible"             ,
     "Text has already destructed"                                      ,
     "Text did not constructed, operation is impossible"                ,
+    "Text is not mapped, its lines are already split"                  ,
+    "Failed to write the BinCode to the file"                          ,
 };
 
 char const * const STRING_LOGNAME = "string.log";
@@ -103,6 +107,12 @@ char const * const STRING_LOGNAME = "string.log";
 //==============================================================================
 
 
+enum TextModes
+{
+    TEXT_READ = 0, // whole file is read and split to lines at once
+    TEXT_MAP  = 1, // file is mapped and split to lines by NextLines
+};
+
 struct Line
 {
     char*  str = nullptr;
@@ -113,6 +123,12 @@ class Text
 {
     int state_;
 
+    int    mode_      = TEXT_READ;
+    size_t map_size_  = 0;  // 0 if the file is read to the heap
+    size_t next_      = 0;  // offset of the text after the last given line
+    size_t released_  = 0;  // mapped bytes given back to the system
+    size_t lines_cap_ = 0;
+
 public:
 
    char*  text_  = nullptr;
@@ -131,9 +147,12 @@ public:
 /*! @brief   Text constructor from file.
  *
  *  @param   filename    Name of the text file
+ *  @param   mode        TEXT_READ or TEXT_MAP
+ *
+ *  @note    In TEXT_MAP mode lines_ is empty until NextLines is called.
  */
 
-    Text (const char* filename);
+    Text (const char* filename, int mode = TEXT_READ);
 
 //------------------------------------------------------------------------------
 /*! @brief   Text constructor with number of lines and their lengths.
@@ -170,6 +189,18 @@ public:
 
     int Expand (size_t line_len);
 
+//------------------------------------------------------------------------------
+/*! @brief   Split the next lines of the mapped text, lines_ keeps only them.
+ *
+ *  @param   lines_max   Maximum number of lines
+ *
+ *  @return  number of lines in lines_, 0 at the end of the text
+ *
+ *  @note    Pages of the lines given before are released.
+ */
+
+    size_t NextLines (size_t lines_max);
+
 //------------------------------------------------------------------------------
 };
 
@@ -178,6 +209,8 @@ class BinCode
 {
     int state_;
 
+    size_t map_size_ = 0;  // 0 if the data is on the heap
+
 public:
 
     char*  data_ = nullptr;
@@ -202,9 +235,12 @@ public:
 /*! @brief   BinCode constructor from file.
  *
  *  @param   filename    Name of the input file
+ *  @param   mode        TEXT_READ or TEXT_MAP
+ *
+ *  @note    Mapped data can not be expanded.
  */
 
-    BinCode (const char* filename);
+    BinCode (const char* filename, int mode = TEXT_READ);
 
 //------------------------------------------------------------------------------
 /*! @brief   BinCode copy constructor (deleted).
@@ -230,6 +266,27 @@ public:
 
 int Expand ();
 
+//------------------------------------------------------------------------------
+/*! @brief   Copy bytes to the data at ptr_ and move ptr_ after them.
+ *
+ *  @param   src         Bytes to copy
+ *  @param   len         Number of bytes
+ *
+ *  @return  error code
+ */
+
+int Put (const void* src, size_t len);
+
+//------------------------------------------------------------------------------
+/*! @brief   Write the data before ptr_ to the file.
+ *
+ *  @param   filename    Name of the output file
+ *
+ *  @return  error code
+ */
+
+int Write (const char* filename);
+
 //------------------------------------------------------------------------------
 };
 
@@ -272,11 +329,36 @@ size_t CountSize (FILE* fp);
  *  @param   fp          Pointer to the file
  *  @param   len         Length of the text
  *
- *  @return  pointer to text
+ *  @return  pointer to text, nullptr if it is not read whole
  */
 
 char* GetText (FILE* fp, size_t len);
 
+//------------------------------------------------------------------------------
+/*! @brief   Map text of the file to memory, changes of it stay private.
+ *
+ *  @param   fp          Pointer to the file
+ *  @param   len         Length of the text
+ *  @param   map_size    Size of the mapped memory, 0 if the text is read to the heap
+ *
+ *  @note    Text is followed by at least one zero byte like GetText has.
+ *
+ *  @return  pointer to text, nullptr if it can not be mapped or read
+ */
+
+char* MapText (FILE* fp, size_t len, size_t& map_size);
+
+//------------------------------------------------------------------------------
+/*! @brief   Find the first new line character.
+ *
+ *  @param   text        Start of the text
+ *  @param   end         End of the text
+ *
+ *  @return  pointer to the new line, end if there is none
+ */
+
+char* FindNewLine (char* text, char* end);
+
 //------------------------------------------------------------------------------
 /*! @brief   Get number of lines in the text.
  *
@@ -0,0 +1,199 @@
+/*------------------------------------------------------------------------------
+    * File:        FlatTree.h                                                  *
+    * Description: Declaration of binary trees kept in contiguous arrays with  *
+                   32-bit indices of children and parents.                     *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+#ifndef FLAT_TREE_H_INCLUDED
+#define FLAT_TREE_H_INCLUDED
+
+#include "TreeConfig.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+
+const uint32_t FLAT_NULL          = UINT32_MAX;
+const size_t   FLAT_MIN_CAPACITY  = 64;
+
+
+template <typename TYPE>
+class FlatTree;
+
+/*
+ * Handle of a flat tree node with the same way of access as Node has,
+ * the node itself is only an index in the arrays of the tree.
+ */
+
+template <typename TYPE>
+class FlatNode
+{
+    FlatTree<TYPE>* tree_  = nullptr;
+    uint32_t        index_ = FLAT_NULL;
+
+public:
+
+//------------------------------------------------------------------------------
+/*! @brief   Flat node constructor.
+ *
+ *  @param   tree        Flat tree of the node
+ *  @param   index       Index of the node, FLAT_NULL for no node
+ */
+
+    FlatNode (FlatTree<TYPE>* tree, uint32_t index);
+
+//------------------------------------------------------------------------------
+/*! @brief   Get node data.
+ *
+ *  @return  node data
+ */
+
+    const TYPE& getData () const;
+
+//------------------------------------------------------------------------------
+/*! @brief   Safe change node data.
+ *
+ *  @param   data        Data to change
+ */
+
+    void setData (TYPE data);
+
+//------------------------------------------------------------------------------
+/*! @brief   Get left, right and previous nodes.
+ *
+ *  @return  node handle, null if there is no such node
+ */
+
+    FlatNode left  () const;
+    FlatNode right () const;
+    FlatNode prev  () const;
+
+//------------------------------------------------------------------------------
+/*! @brief   Depth of the node, counted by the previous nodes.
+ *
+ *  @return  depth
+ */
+
+    size_t depth () const;
+
+//------------------------------------------------------------------------------
+/*! @brief   Check if the handle points to no node.
+ *
+ *  @return  true if null, else false
+ */
+
+    bool isNull () const;
+
+//------------------------------------------------------------------------------
+/*! @brief   Get index of the node.
+ *
+ *  @return  index
+ */
+
+    uint32_t getIndex () const;
+
+//------------------------------------------------------------------------------
+};
+
+
+template <typename TYPE>
+class FlatTree
+{
+    int errCode_ = TREE_OK;
+
+public:
+
+    uint32_t* left_  = nullptr;
+    uint32_t* right_ = nullptr;
+    uint32_t* prev_  = nullptr;
+    TYPE*     data_  = nullptr;
+
+    size_t    size_     = 0;
+    size_t    capacity_ = 0;
+    uint32_t  root_     = FLAT_NULL;
+
+//------------------------------------------------------------------------------
+/*! @brief   Flat tree constructor.
+ *
+ *  @param   capacity    Number of nodes to reserve
+ */
+
+    FlatTree (size_t capacity = FLAT_MIN_CAPACITY);
+
+//------------------------------------------------------------------------------
+/*! @brief   Flat tree copy constructor (deleted).
+ *
+ *  @param   obj         Source flat tree
+ */
+
+    FlatTree (const FlatTree& obj);
+
+    FlatTree& operator = (const FlatTree& obj); // deleted
+
+//------------------------------------------------------------------------------
+/*! @brief   Flat tree destructor.
+ */
+
+   ~FlatTree ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Add node over already added children, the last added node is the root.
+ *
+ *  @param   data        Node data
+ *  @param   left        Index of the left child or FLAT_NULL
+ *  @param   right       Index of the right child or FLAT_NULL
+ *
+ *  @note    Children always go before parents, so the arrays are in post-order.
+ *
+ *  @return  index of the node
+ */
+
+    uint32_t Add (TYPE data, uint32_t left, uint32_t right);
+
+//------------------------------------------------------------------------------
+/*! @brief   Remove all nodes, memory is kept.
+ */
+
+    void Clean ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Get handle of the root node.
+ *
+ *  @return  root handle
+ */
+
+    FlatNode<TYPE> getRoot ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Get error code of the tree.
+ *
+ *  @return  error code
+ */
+
+    int getErrCode ();
+
+/*------------------------------------------------------------------------------
+                   Private functions                                           *
+*///----------------------------------------------------------------------------
+
+private:
+
+//------------------------------------------------------------------------------
+/*! @brief   Double the capacity of all arrays.
+ *
+ *  @return  error code
+ */
+
+    int Expand ();
+
+//------------------------------------------------------------------------------
+};
+
+#include "FlatTree.ipp"
+
+#endif // FLAT_TREE_H_INCLUDED
@@ -0,0 +1,226 @@
+/*------------------------------------------------------------------------------
+    * File:        FlatTree.ipp                                                *
+    * Description: Functions for binary trees kept in contiguous arrays.       *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+template <typename TYPE>
+FlatNode<TYPE>::FlatNode (FlatTree<TYPE>* tree, uint32_t index) :
+    tree_  (tree),
+    index_ (index)
+{
+    assert(tree != nullptr);
+    assert((index == FLAT_NULL) || (index < tree->size_));
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+const TYPE& FlatNode<TYPE>::getData () const
+{
+    assert(index_ != FLAT_NULL);
+
+    return tree_->data_[index_];
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+void FlatNode<TYPE>::setData (TYPE data)
+{
+    assert(index_ != FLAT_NULL);
+
+    tree_->data_[index_] = data;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+FlatNode<TYPE> FlatNode<TYPE>::left () const
+{
+    assert(index_ != FLAT_NULL);
+
+    return FlatNode(tree_, tree_->left_[index_]);
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+FlatNode<TYPE> FlatNode<TYPE>::right () const
+{
+    assert(index_ != FLAT_NULL);
+
+    return FlatNode(tree_, tree_->right_[index_]);
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+FlatNode<TYPE> FlatNode<TYPE>::prev () const
+{
+    assert(index_ != FLAT_NULL);
+
+    return FlatNode(tree_, tree_->prev_[index_]);
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+size_t FlatNode<TYPE>::depth () const
+{
+    assert(index_ != FLAT_NULL);
+
+    size_t depth = 0;
+    for (uint32_t index = tree_->prev_[index_]; index != FLAT_NULL; index = tree_->prev_[index])
+        ++depth;
+
+    return depth;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+bool FlatNode<TYPE>::isNull () const
+{
+    return index_ == FLAT_NULL;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+uint32_t FlatNode<TYPE>::getIndex () const
+{
+    return index_;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+FlatTree<TYPE>::FlatTree (size_t capacity) :
+    capacity_ ((capacity < FLAT_MIN_CAPACITY) ? FLAT_MIN_CAPACITY : capacity)
+{
+    left_  = new uint32_t[capacity_];
+    right_ = new uint32_t[capacity_];
+    prev_  = new uint32_t[capacity_];
+    data_  = new TYPE    [capacity_];
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+FlatTree<TYPE>::~FlatTree ()
+{
+    if (errCode_ == TREE_DESTRUCTED) return;
+
+    delete [] left_;
+    delete [] right_;
+    delete [] prev_;
+    delete [] data_;
+
+    left_  = nullptr;
+    right_ = nullptr;
+    prev_  = nullptr;
+    data_  = nullptr;
+
+    size_     = 0;
+    capacity_ = 0;
+    root_     = FLAT_NULL;
+
+    errCode_ = TREE_DESTRUCTED;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+uint32_t FlatTree<TYPE>::Add (TYPE data, uint32_t left, uint32_t right)
+{
+    assert((left  == FLAT_NULL) || (left  < size_));
+    assert((right == FLAT_NULL) || (right < size_));
+
+    if (size_ == capacity_)
+    {
+        errCode_ = Expand();
+        if (errCode_) return FLAT_NULL;
+    }
+
+    uint32_t index = (uint32_t)size_++;
+
+    left_ [index] = left;
+    right_[index] = right;
+    prev_ [index] = FLAT_NULL;
+    data_ [index] = data;
+
+    if (left  != FLAT_NULL) prev_[left]  = index;
+    if (right != FLAT_NULL) prev_[right] = index;
+
+    root_ = index;
+
+    return index;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+void FlatTree<TYPE>::Clean ()
+{
+    size_ = 0;
+    root_ = FLAT_NULL;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+FlatNode<TYPE> FlatTree<TYPE>::getRoot ()
+{
+    return FlatNode<TYPE>(this, root_);
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+int FlatTree<TYPE>::getErrCode ()
+{
+    return errCode_;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+int FlatTree<TYPE>::Expand ()
+{
+    /* indices are 32-bit, FLAT_NULL is reserved */
+    if (capacity_ >= FLAT_NULL / 2) return TREE_NO_MEMORY;
+
+    size_t capacity = 2 * capacity_;
+
+    uint32_t* left  = new uint32_t[capacity];
+    uint32_t* right = new uint32_t[capacity];
+    uint32_t* prev  = new uint32_t[capacity];
+    TYPE*     data  = new TYPE    [capacity];
+
+    memcpy(left,  left_,  size_ * sizeof(uint32_t));
+    memcpy(right, right_, size_ * sizeof(uint32_t));
+    memcpy(prev,  prev_,  size_ * sizeof(uint32_t));
+
+    for (size_t i = 0; i < size_; ++i) data[i] = data_[i];
+
+    delete [] left_;
+    delete [] right_;
+    delete [] prev_;
+    delete [] data_;
+
+    left_  = left;
+    right_ = right;
+    prev_  = prev;
+    data_  = data;
+
+    capacity_ = capacity;
+
+    return TREE_OK;
+}
+
+//------------------------------------------------------------------------------
@@ -19,7 +19,9 @@
 
 #define NO_DUMP
 #define NO_HASH
+#define NO_POISON
 #include "../StackLib/Stack.h"
+#undef NO_POISON
 #undef NO_HASH
 #undef NO_DUMP
 
@@ -71,6 +73,9 @@ static int tree_id = 0;
 template <typename TYPE>
 class Tree;
 
+template <typename TYPE>
+class NodeArena;
+
 template<typename TYPE> const char* const PRINT_TYPE<Tree<TYPE>> = "Tree";
 template<typename TYPE> const Tree<TYPE>  POISON    <Tree<TYPE>> = {};
 
@@ -82,9 +87,11 @@ template <typename TYPE>
 class Node
 {
     friend class Tree<TYPE>;
+    friend class NodeArena<TYPE>;
 
     TYPE data_      = POISON<TYPE>;
     bool is_string_ = false;
+    bool in_arena_  = false;
 
 public:
 
@@ -103,11 +110,21 @@ public:
 //------------------------------------------------------------------------------
 /*! @brief   Node destruction.
  *
- *  @note    All nodes must be created by operator new!!!
+ *  @note    All nodes must be created by operator new or by the arena!!!
  */
 
     ~Node ();
 
+//------------------------------------------------------------------------------
+/*! @brief   Delete the node with its subtree.
+ *
+ *  @param   node        Node created by operator new or by the arena
+ *
+ *  @note    Memory of the arena nodes returns only with the whole arena.
+ */
+
+    static void Delete (Node* node);
+
 //------------------------------------------------------------------------------
 /*! @brief   Safe change node data.
  *
@@ -136,6 +153,25 @@ public:
 
     void recountPrev ();
 
+//------------------------------------------------------------------------------
+/*! @brief   Get the first node of the subtree in post-order
+ *           (left subtree, right subtree, node).
+ *
+ *  @return  the lowest node of the leftmost path
+ */
+
+    Node* firstPostorder ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Get the next node in post-order, the walk goes up by prev_.
+ *
+ *  @param   root        Root of the walked subtree
+ *
+ *  @return  next node, nullptr after the root
+ */
+
+    Node* nextPostorder (const Node* root);
+
 //------------------------------------------------------------------------------
 /*! @brief   Node copy constructor.
  *
@@ -146,6 +182,16 @@ public:
 
     Node& operator = (const Node& obj);
 
+//------------------------------------------------------------------------------
+/*! @brief   Node move constructor, children are taken without copying.
+ *
+ *  @param   obj         Source node, it stays without children
+ */
+
+    Node (Node&& obj);
+
+    Node& operator = (Node&& obj);
+
 private:
 
 //------------------------------------------------------------------------------
@@ -176,10 +222,11 @@ private:
  *  @return  1 if found, 0 if not
  */
 
-    bool findPath (Stack<size_t>& path, TYPE elem);
+    template <size_t N>
+    bool findPath (Stack<size_t, N>& path, TYPE elem);
 
 //------------------------------------------------------------------------------
-/*! @brief   Recursive node checker.
+/*! @brief   Node checker, the subtree is walked by prev_ without recursion.
  *
  *  @param   tree        Tree of the node
  *
@@ -200,6 +247,69 @@ private:
 };
 
 
+const size_t ARENA_MIN_CHUNK_NODES = 64;
+const size_t ARENA_MAX_CHUNK_NODES = 65536;
+
+template <typename TYPE>
+class NodeArena
+{
+    /* nodes of the arena are never destructed one by one */
+    static_assert(std::is_trivially_destructible<TYPE>::value, "arena data must be trivially destructible");
+
+    struct Chunk
+    {
+        Chunk* prev     = nullptr;
+        size_t capacity = 0;
+    };
+
+    Chunk* chunk_      = nullptr;
+    size_t chunk_used_ = 0;
+
+public:
+
+    size_t nodes_num_  = 0;
+    size_t chunks_num_ = 0;
+
+//------------------------------------------------------------------------------
+/*! @brief   Arena constructor, memory is taken by the first node.
+ */
+
+    NodeArena ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Arena copy constructor (deleted).
+ *
+ *  @param   obj         Source arena
+ */
+
+    NodeArena (const NodeArena& obj);
+
+    NodeArena& operator = (const NodeArena& obj); // deleted
+
+//------------------------------------------------------------------------------
+/*! @brief   Arena destructor, frees all chunks.
+ */
+
+   ~NodeArena ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Get a new node placed right after the previous one.
+ *
+ *  @return  pointer to the node
+ */
+
+    Node<TYPE>* New ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Free all nodes at once, the newest (largest) chunk is kept for reuse.
+ */
+
+    void Release ();
+
+//------------------------------------------------------------------------------
+};
+
+
 template <typename TYPE>
 class Tree
 {
@@ -208,7 +318,9 @@ class Tree
     int id_ = 0;
     int errCode_ = 0;
 
-    Stack<TYPE> path2badnode_;
+    Stack<TYPE, TREE_PATH_INLINE> path2badnode_;
+
+    NodeArena<TYPE>* arena_ = nullptr;
 
 public:
 
@@ -263,12 +375,47 @@ public:
 
     Tree& operator = (const Tree& obj);
 
+//------------------------------------------------------------------------------
+/*! @brief   Tree move constructor, nodes and arena are taken without copying.
+ *
+ *  @param   obj         Source tree, it stays empty
+ */
+
+    Tree (Tree&& obj);
+
+    Tree& operator = (Tree&& obj);
+
 //------------------------------------------------------------------------------
 /*! @brief   Clean tree.
  */
 
     void Clean ();
 
+//------------------------------------------------------------------------------
+/*! @brief   Make the tree own an arena, then its nodes are freed at once.
+ *
+ *  @note    All nodes of such a tree must be created by NewNode.
+ *           The arena is not copied with the tree.
+ */
+
+    void useArena ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Create a node in the arena of the tree or by operator new.
+ *
+ *  @return  pointer to the node
+ */
+
+    Node<TYPE>* NewNode ();
+
+//------------------------------------------------------------------------------
+/*! @brief   Get the arena of the tree.
+ *
+ *  @return  pointer to the arena, nullptr if the tree does not use it
+ */
+
+    NodeArena<TYPE>* getArena ();
+
 //------------------------------------------------------------------------------
 /*! @brief   Print the contents of the tree like a graphviz dot file.
  *
@@ -294,7 +441,8 @@ public:
  *  @return  1 if found, 0 if not
  */
 
-    bool findPath (Stack<size_t>& path, TYPE elem);
+    template <size_t N>
+    bool findPath (Stack<size_t, N>& path, TYPE elem);
 
 //------------------------------------------------------------------------------
 /*! @brief   Check tree for problems.
@@ -20,22 +20,22 @@ Tree<TYPE>::Tree () : errCode_ (TREE_NOT_CONSTRUCTED) { }
 
 template <typename TYPE>
 Tree<TYPE>::Tree (char* tree_name) :
-    name_         (tree_name),
     id_           (tree_id++),
-    root_         (nullptr),
+    errCode_      (TREE_OK),
     path2badnode_ ((char*)"path to problem node"),
-    errCode_      (TREE_OK)
+    name_         (tree_name),
+    root_         (nullptr)
 {}
 
 //------------------------------------------------------------------------------
 
 template <typename TYPE>
 Tree<TYPE>::Tree (char* tree_name, Node<TYPE>* root) :
-    name_         (tree_name),
-    root_         (root),
     id_           (tree_id++),
+    errCode_      (TREE_OK),
     path2badnode_ ((char*)"path to problem node"),
-    errCode_      (TREE_OK)
+    name_         (tree_name),
+    root_         (root)
 {
     TREE_CHECK;
 }
@@ -44,10 +44,10 @@ Tree<TYPE>::Tree (char* tree_name, Node<TYPE>* root) :
 
 template <typename TYPE>
 Tree<TYPE>::Tree (char* tree_name, char* base_filename) :
-    name_         (tree_name),
     id_           (tree_id++),
+    errCode_      (TREE_OK),
     path2badnode_ ((char*)"path to problem node"),
-    errCode_      (TREE_OK)
+    name_         (tree_name)
 {
     TREE_ASSERTOK((tree_name == nullptr), TREE_WRONG_INPUT_TREE_NAME, -1);
 
@@ -76,7 +76,8 @@ Tree<TYPE>::Tree (char* tree_name, char* base_filename) :
 //------------------------------------------------------------------------------
 
 template <typename TYPE>
-Tree<TYPE>::Tree (const Tree& obj)
+Tree<TYPE>::Tree (const Tree& obj) :
+    path2badnode_ ((char*)"path to problem node")
 {
     *this = obj;
 }
@@ -88,12 +89,72 @@ Tree<TYPE>& Tree<TYPE>::operator = (const Tree& obj)
 {
     name_ = obj.name_;
 
+    /* copied nodes are created by operator new, so the arena goes away */
+    if (arena_ != nullptr)
+    {
+        root_ = nullptr;
+
+        delete arena_;
+        arena_ = nullptr;
+    }
+
     if (obj.root_ != nullptr)
     {
         if (root_ == nullptr) root_ = new Node<TYPE>;
         *root_ = *obj.root_;
     }
-    else root_ = nullptr;
+    else
+    {
+        Node<TYPE>::Delete(root_);
+        root_ = nullptr;
+    }
+
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+Tree<TYPE>::Tree (Tree&& obj) :
+    id_           (obj.id_),
+    errCode_      (obj.errCode_),
+    path2badnode_ ((char*)"path to problem node"),
+    arena_        (obj.arena_),
+    name_         (obj.name_),
+    root_         (obj.root_)
+{
+    obj.root_    = nullptr;
+    obj.arena_   = nullptr;
+    obj.errCode_ = TREE_NOT_CONSTRUCTED;
+}
+
+//------------------------------------------------------------------------------
+
+/*
+ * errCode_ is not taken, as with the copy.
+ */
+
+template <typename TYPE>
+Tree<TYPE>& Tree<TYPE>::operator = (Tree&& obj)
+{
+    if (this == &obj) return *this;
+
+    if (arena_ != nullptr)
+    {
+        root_ = nullptr;
+
+        delete arena_;
+        arena_ = nullptr;
+    }
+
+    Node<TYPE>::Delete(root_);
+
+    name_  = obj.name_;
+    root_  = obj.root_;
+    arena_ = obj.arena_;
+
+    obj.root_  = nullptr;
+    obj.arena_ = nullptr;
 
     return *this;
 }
@@ -107,9 +168,17 @@ Tree<TYPE>::~Tree ()
 
     else if (errCode_ != TREE_DESTRUCTED)
     {
+        if (arena_ != nullptr)
+        {
+            root_ = nullptr;
+
+            delete arena_;
+            arena_ = nullptr;
+        }
+
         if (root_ != nullptr)
         {
-            delete root_;
+            Node<TYPE>::Delete(root_);
             root_ = nullptr;
         }
 
@@ -128,15 +197,123 @@ void Tree<TYPE>::Clean ()
 {
     TREE_CHECK;
 
+    if (arena_ != nullptr)
+    {
+        root_ = nullptr;
+        arena_->Release();
+    }
+
     if (root_ != nullptr)
     {
-        delete root_;
+        Node<TYPE>::Delete(root_);
         root_ = nullptr;
     }
 }
 
 //------------------------------------------------------------------------------
 
+template <typename TYPE>
+void Tree<TYPE>::useArena ()
+{
+    TREE_ASSERTOK((root_ != nullptr), TREE_NOT_OK, -1);
+
+    if (arena_ == nullptr) arena_ = new NodeArena<TYPE>;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+Node<TYPE>* Tree<TYPE>::NewNode ()
+{
+    if (arena_ != nullptr) return arena_->New();
+
+    return new Node<TYPE>;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+NodeArena<TYPE>* Tree<TYPE>::getArena ()
+{
+    return arena_;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+NodeArena<TYPE>::NodeArena () { }
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+NodeArena<TYPE>::~NodeArena ()
+{
+    while (chunk_ != nullptr)
+    {
+        Chunk* prev = chunk_->prev;
+        ::operator delete(chunk_);
+
+        chunk_ = prev;
+    }
+
+    chunk_used_ = 0;
+    nodes_num_  = 0;
+    chunks_num_ = 0;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+Node<TYPE>* NodeArena<TYPE>::New ()
+{
+    if ((chunk_ == nullptr) || (chunk_used_ == chunk_->capacity))
+    {
+        size_t capacity = (chunk_ == nullptr) ? ARENA_MIN_CHUNK_NODES : 2 * chunk_->capacity;
+        if (capacity > ARENA_MAX_CHUNK_NODES) capacity = ARENA_MAX_CHUNK_NODES;
+
+        /* nodes go right after the header, it is padded to their alignment */
+        static_assert(sizeof(Chunk) % alignof(Node<TYPE>) == 0, "chunk header breaks node alignment");
+
+        Chunk* chunk = (Chunk*)::operator new(sizeof(Chunk) + capacity * sizeof(Node<TYPE>));
+        chunk->prev     = chunk_;
+        chunk->capacity = capacity;
+
+        chunk_      = chunk;
+        chunk_used_ = 0;
+        ++chunks_num_;
+    }
+
+    Node<TYPE>* node = new ((Node<TYPE>*)(chunk_ + 1) + chunk_used_++) Node<TYPE>;
+    node->in_arena_ = true;
+
+    ++nodes_num_;
+
+    return node;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+void NodeArena<TYPE>::Release ()
+{
+    if (chunk_ == nullptr) return;
+
+    /* the newest chunk is the largest one, new nodes keep growing from it */
+    while (chunk_->prev != nullptr)
+    {
+        Chunk* prev = chunk_->prev->prev;
+        ::operator delete(chunk_->prev);
+
+        chunk_->prev = prev;
+    }
+
+    chunk_used_ = 0;
+    nodes_num_  = 0;
+    chunks_num_ = 1;
+}
+
+//------------------------------------------------------------------------------
+
 template <typename TYPE>
 Node<TYPE>::Node (const Node& obj)
 {
@@ -164,7 +341,7 @@ Node<TYPE>& Node<TYPE>::operator = (const Node& obj)
 
     if (obj.right_ != nullptr)
     {
-        if (right_ != nullptr) delete right_;
+        if (right_ != nullptr) Delete(right_);
         right_ = new Node<TYPE>;
 
         *right_ = *obj.right_;
@@ -172,13 +349,13 @@ Node<TYPE>& Node<TYPE>::operator = (const Node& obj)
     }
     else if (right_ != nullptr)
     {
-        delete right_;
+        Delete(right_);
         right_ = nullptr;
     }
     
     if (obj.left_ != nullptr)
     {
-        if (left_ != nullptr) delete left_;
+        if (left_ != nullptr) Delete(left_);
         left_ = new Node<TYPE>;
 
         *left_ = *obj.left_;
@@ -186,7 +363,7 @@ Node<TYPE>& Node<TYPE>::operator = (const Node& obj)
     }
     else if (left_ != nullptr)
     {
-        delete left_;
+        Delete(left_);
         left_ = nullptr;
     }
 
@@ -198,19 +375,68 @@ Node<TYPE>& Node<TYPE>::operator = (const Node& obj)
 
 //------------------------------------------------------------------------------
 
+template <typename TYPE>
+Node<TYPE>::Node (Node&& obj)
+{
+    *this = std::move(obj);
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+Node<TYPE>& Node<TYPE>::operator = (Node&& obj)
+{
+    if (this == &obj) return *this;
+
+    if constexpr (std::is_same<TYPE, char*>::value) if (is_string_) delete [] data_;
+
+    Delete(right_);
+    Delete(left_);
+
+    data_      = obj.data_;
+    is_string_ = obj.is_string_;
+    right_     = obj.right_;
+    left_      = obj.left_;
+
+    if (right_ != nullptr) right_->prev_ = this;
+    if (left_  != nullptr) left_->prev_  = this;
+
+    obj.is_string_ = false;
+    obj.right_     = nullptr;
+    obj.left_      = nullptr;
+
+    if (prev_ == nullptr) depth_ = 0;
+    else depth_ = prev_->depth_ + 1;
+
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+
 template <typename TYPE>
 Node<TYPE>::~Node ()
 {
-    if (right_ != nullptr)
-    {
-        delete right_;
-        right_ = nullptr;
-    }
+    /* subtrees are deleted by the list linked through prev_, not recursively */
+    Node<TYPE>* pending = nullptr;
 
-    if (left_ != nullptr)
+    if (right_ != nullptr) { right_->prev_ = pending; pending = right_; }
+    if (left_  != nullptr) { left_->prev_  = pending; pending = left_;  }
+
+    right_ = nullptr;
+    left_  = nullptr;
+
+    while (pending != nullptr)
     {
-        delete left_;
-        left_  = nullptr;
+        Node<TYPE>* node_cur = pending;
+        pending = node_cur->prev_;
+
+        if (node_cur->right_ != nullptr) { node_cur->right_->prev_ = pending; pending = node_cur->right_; }
+        if (node_cur->left_  != nullptr) { node_cur->left_->prev_  = pending; pending = node_cur->left_;  }
+
+        node_cur->right_ = nullptr;
+        node_cur->left_  = nullptr;
+
+        Delete(node_cur);
     }
 
     prev_ = nullptr;
@@ -224,6 +450,19 @@ Node<TYPE>::~Node ()
 
 //------------------------------------------------------------------------------
 
+template <typename TYPE>
+void Node<TYPE>::Delete (Node<TYPE>* node)
+{
+    if (node == nullptr) return;
+
+    if (node->in_arena_)
+        node->~Node();
+    else
+        delete node;
+}
+
+//------------------------------------------------------------------------------
+
 template <typename TYPE>
 int Node<TYPE>::AddFromBase (const Text& base, size_t& line_cur)
 {
@@ -462,8 +701,26 @@ void Node<TYPE>::recountDepth ()
     else
         depth_ = prev_->depth_ + 1;
 
-    if (right_ != nullptr) right_->recountDepth();
-    if (left_  != nullptr) left_->recountDepth();
+    /* walk down and up by prev_, so deep trees do not overflow the call stack */
+    Node<TYPE>* node_cur = this;
+
+    while (true)
+    {
+        Node<TYPE>* next = (node_cur->right_ != nullptr) ? node_cur->right_ : node_cur->left_;
+
+        while ((next == nullptr) && (node_cur != this))
+        {
+            Node<TYPE>* prev = node_cur->prev_;
+            if ((node_cur == prev->right_) && (prev->left_ != nullptr)) next = prev->left_;
+
+            node_cur = prev;
+        }
+
+        if (next == nullptr) break;
+
+        next->depth_ = node_cur->depth_ + 1;
+        node_cur = next;
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -473,22 +730,68 @@ void Node<TYPE>::recountPrev ()
 {
     assert(this != nullptr);
 
-    if (right_ != nullptr)
-    {
-        right_->prev_ = this;
-        right_->recountPrev();
-    }
-    if (left_  != nullptr)
+    /* prev_ is set on the way down, so it is right on the way up */
+    Node<TYPE>* node_cur = this;
+
+    while (true)
     {
-        left_->prev_ = this;
-        left_->recountPrev();
+        Node<TYPE>* next = (node_cur->right_ != nullptr) ? node_cur->right_ : node_cur->left_;
+
+        while ((next == nullptr) && (node_cur != this))
+        {
+            Node<TYPE>* prev = node_cur->prev_;
+            if ((node_cur == prev->right_) && (prev->left_ != nullptr))
+            {
+                next     = prev->left_;
+                node_cur = prev;
+                break;
+            }
+
+            node_cur = prev;
+        }
+
+        if (next == nullptr) break;
+
+        next->prev_ = node_cur;
+        node_cur = next;
     }
 }
 
 //------------------------------------------------------------------------------
 
 template <typename TYPE>
-bool Tree<TYPE>::findPath (Stack<size_t>& path, TYPE elem)
+Node<TYPE>* Node<TYPE>::firstPostorder ()
+{
+    assert(this != nullptr);
+
+    Node<TYPE>* node_cur = this;
+    while ((node_cur->left_ != nullptr) || (node_cur->right_ != nullptr))
+        node_cur = (node_cur->left_ != nullptr) ? node_cur->left_ : node_cur->right_;
+
+    return node_cur;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+Node<TYPE>* Node<TYPE>::nextPostorder (const Node<TYPE>* root)
+{
+    assert(this != nullptr);
+
+    /* prev_ of the root may point out of the subtree, it is not used */
+    if (this == root) return nullptr;
+
+    if ((this == prev_->left_) && (prev_->right_ != nullptr))
+        return prev_->right_->firstPostorder();
+
+    return prev_;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE>
+template <size_t N>
+bool Tree<TYPE>::findPath (Stack<size_t, N>& path, TYPE elem)
 {
     TREE_CHECK;
 
@@ -502,7 +805,8 @@ bool Tree<TYPE>::findPath (Stack<size_t>& path, TYPE elem)
 //------------------------------------------------------------------------------
 
 template <typename TYPE>
-bool Node<TYPE>::findPath (Stack<size_t>& path, TYPE elem)
+template <size_t N>
+bool Node<TYPE>::findPath (Stack<size_t, N>& path, TYPE elem)
 {
     path.Push((size_t)this);
     
@@ -571,51 +875,61 @@ int Tree<TYPE>::Check ()
 template <typename TYPE>
 int Node<TYPE>::Check (Tree<TYPE>& tree)
 {
-    if (((prev_ == nullptr) && (depth_ != 0)) ||
-        ((prev_ != nullptr) && (depth_ != prev_->depth_ + 1)))
+    int err = TREE_OK;
+
+    /* nodes are checked in the order node, right, left by the walk through prev_ */
+    Node<TYPE>* node_cur = this;
+    while (true)
     {
-        tree.path2badnode_.Push(data_);
-        return TREE_WRONG_DEPTH;
-    }
+        Node<TYPE>* prev = node_cur->prev_;
 
-    if (prev_ != nullptr)
-        if ((prev_->right_ != this) &&
-            (prev_->left_  != this))
-        {
-            tree.path2badnode_.Push(data_);
-            return TREE_WRONG_PREV_NODE;
-        }
+        if (((prev == nullptr) && (node_cur->depth_ != 0)) ||
+            ((prev != nullptr) && (node_cur->depth_ != prev->depth_ + 1)))
+            err = TREE_WRONG_DEPTH;
+        else
+        if ((prev != nullptr) && (prev->right_ != node_cur) && (prev->left_ != node_cur))
+            err = TREE_WRONG_PREV_NODE;
+        else
+        if ((node_cur->right_ != nullptr) && (node_cur->right_->prev_ != node_cur))
+            err = TREE_WRONG_PREV_NODE;
+        else
+        if ((node_cur->left_ != nullptr) && (node_cur->left_->prev_ != node_cur))
+            err = TREE_WRONG_PREV_NODE;
 
-    if (right_ != nullptr)
-        if (right_->prev_ != this)
-        {
-            tree.path2badnode_.Push(data_);
-            return TREE_WRONG_PREV_NODE;
-        }
+        if (err) break;
 
-    if (left_ != nullptr)
-        if (left_->prev_ != this)
+        if (node_cur->right_ != nullptr)
+            node_cur = node_cur->right_;
+        else
+        if (node_cur->left_ != nullptr)
+            node_cur = node_cur->left_;
+        else
         {
-            tree.path2badnode_.Push(data_);
-            return TREE_WRONG_PREV_NODE;
+            /* prev_ of the checked nodes is right, go up to the first unchecked left subtree */
+            while (true)
+            {
+                if (node_cur == this) return TREE_OK;
+
+                Node<TYPE>* parent = node_cur->prev_;
+                if ((node_cur == parent->right_) && (parent->left_ != nullptr) && (parent->left_ != node_cur))
+                {
+                    node_cur = parent->left_;
+                    break;
+                }
+
+                node_cur = parent;
+            }
         }
+    }
 
-    int err = TREE_OK;
-
-    if (right_ != nullptr)
-        err = right_->Check(tree);
-
-    if (err)
+    /* path from the bad node up to this one */
+    tree.path2badnode_.Push(node_cur->data_);
+    while (node_cur != this)
     {
-        tree.path2badnode_.Push(data_);
-        return err;
+        node_cur = node_cur->prev_;
+        tree.path2badnode_.Push(node_cur->data_);
     }
 
-    if (left_ != nullptr)
-        err = left_->Check(tree);
-
-    if (err) tree.path2badnode_.Push(data_);
-
     return err;
 }
 
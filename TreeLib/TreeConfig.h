@@ -41,6 +41,8 @@ char const * const TREE_LOGNAME      = "tree.log";
 const char OPEN_BRACKET  = '[';
 const char CLOSE_BRACKET = ']';
 
+const size_t TREE_PATH_INLINE = 8; // nodes of the path to a bad node kept in the tree
+
 
 enum TreeErrors
 {
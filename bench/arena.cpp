@@ -0,0 +1,113 @@
+/*------------------------------------------------------------------------------
+    * File:        arena.cpp                                                   *
+    * Description: Benchmark of the expression trees with and without the      *
+    *              node arena.                                                 *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+#include "../Calculator/Calculator.h"
+#include <chrono>
+
+static size_t allocs = 0;
+
+void* operator new   (size_t size) { ++allocs; return malloc(size); }
+void* operator new[] (size_t size) { ++allocs; return malloc(size); }
+
+void operator delete   (void* ptr) noexcept { free(ptr); }
+void operator delete[] (void* ptr) noexcept { free(ptr); }
+void operator delete   (void* ptr, size_t) noexcept { free(ptr); }
+void operator delete[] (void* ptr, size_t) noexcept { free(ptr); }
+
+//------------------------------------------------------------------------------
+
+/* balanced expression with 2^depth numbers */
+static void Generate (char* str, size_t& pos, int depth, unsigned& seed)
+{
+    seed = seed * 1103515245 + 12345;
+
+    if (depth == 0)
+    {
+        pos += sprintf(str + pos, "%u.5", seed % 100);
+        return;
+    }
+
+    str[pos++] = '(';
+    Generate(str, pos, depth - 1, seed);
+    str[pos++] = "+-"[(seed >> 16) & 1];
+    Generate(str, pos, depth - 1, seed);
+    str[pos++] = ')';
+}
+
+//------------------------------------------------------------------------------
+
+static NUM_TYPE Eval (Node<CalcNodeData>* node)
+{
+    if (node->getData().node_type == NODE_NUMBER) return node->getData().number;
+
+    return calcOperator(node->getData().op_code, Eval(node->left_), Eval(node->right_));
+}
+
+//------------------------------------------------------------------------------
+
+static void Run (char* str, bool arena)
+{
+    const int runs = 5;
+
+    double parse_time   = 0;
+    double eval_time    = 0;
+    double destroy_time = 0;
+    size_t tree_allocs  = 0;
+
+    for (int i = 0; i < runs; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        {
+            Tree<CalcNodeData> tree((char*)"arena");
+            if (arena) tree.useArena();
+
+            size_t allocs_start = allocs;
+
+            Expression expr = { str, str };
+            Expr2Tree(expr, tree);
+
+            tree_allocs = allocs - allocs_start;
+
+            auto parsed = std::chrono::steady_clock::now();
+            Eval(tree.root_);
+            auto evaluated = std::chrono::steady_clock::now();
+
+            parse_time += std::chrono::duration<double, std::milli>(parsed    - start ).count();
+            eval_time  += std::chrono::duration<double, std::milli>(evaluated - parsed).count();
+
+            start = std::chrono::steady_clock::now();
+        }
+        destroy_time += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    printf("arena:  %s %8zu allocations, parse %6.1f ms, eval %5.1f ms, destroy %5.1f ms\n",
+           arena ? "arena" : "heap ", tree_allocs, parse_time / runs, eval_time / runs, destroy_time / runs);
+}
+
+//------------------------------------------------------------------------------
+
+int main ()
+{
+    /* 2^19 numbers, about 1M nodes */
+    char*    str  = new char[64 << 20];
+    size_t   pos  = 0;
+    unsigned seed = 1;
+
+    Generate(str, pos, 19, seed);
+    str[pos] = '\0';
+
+    Run(str, false);
+    Run(str, true);
+
+    delete [] str;
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+/*------------------------------------------------------------------------------
+    * File:        batch.cpp                                                   *
+    * Description: Benchmark of the batch evaluation on 1 to N threads.        *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+#include "../Calculator/Calculator.h"
+#include <chrono>
+
+//------------------------------------------------------------------------------
+
+int main ()
+{
+    const size_t rows_num = 10000000;
+
+    char str[] = "sin(x)*y+x^2/(y+1)-sqrt(x*y)";
+
+    Calculator calc;
+
+    Tree<CalcNodeData> tree((char*)"batch");
+    Expression expr = { str, str };
+    if (Expr2Tree(expr, tree)) return 1;
+
+    const char* names[] = { "x", "y" };
+
+    NUM_TYPE* x      = new NUM_TYPE[rows_num];
+    NUM_TYPE* y      = new NUM_TYPE[rows_num];
+    NUM_TYPE* serial = new NUM_TYPE[rows_num];
+    NUM_TYPE* output = new NUM_TYPE[rows_num];
+
+    for (size_t i = 0; i < rows_num; ++i)
+    {
+        x[i] = 0.5 + (double)(i % 1000) / 1000;
+        y[i] = 1.0 + (double)(i % 7)    / 7;
+    }
+
+    const NUM_TYPE* columns[] = { x, y };
+
+    /* one thread is the serial path, the others must give the same bits */
+    calc.setThreadsNum(1);
+    if (calc.EvaluateBatch(tree, names, columns, 2, serial, rows_num)) return 1;
+
+    bool same = true;
+
+    int threads_max = omp_get_max_threads();
+    for (int threads = 1; threads <= threads_max; ++threads)
+    {
+        calc.setThreadsNum(threads);
+
+        auto start = std::chrono::steady_clock::now();
+        if (calc.EvaluateBatch(tree, names, columns, 2, output, rows_num)) return 1;
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        bool equal = (memcmp(output, serial, rows_num * sizeof(NUM_TYPE)) == 0);
+        same = same && equal;
+
+        printf("batch:  %zuM rows, %2d threads %6.3f s, %s\n", rows_num / 1000000, threads, time,
+               equal ? "same as serial" : "DIFFERENT FROM SERIAL");
+    }
+
+    delete [] x;
+    delete [] y;
+    delete [] serial;
+    delete [] output;
+
+    return same ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+/*------------------------------------------------------------------------------
+    * File:        fold.cpp                                                    *
+    * Description: Benchmark of the constant folding in Optimize.              *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+#include "../Calculator/Calculator.h"
+#include <chrono>
+#include <string>
+
+//------------------------------------------------------------------------------
+
+static size_t CountNodes (Node<CalcNodeData>* node)
+{
+    if (node == nullptr) return 0;
+
+    return 1 + CountNodes(node->left_) + CountNodes(node->right_);
+}
+
+//------------------------------------------------------------------------------
+
+static NUM_TYPE Eval (Node<CalcNodeData>* node)
+{
+    CalcNodeData data = node->getData();
+
+    switch (data.node_type)
+    {
+    case NODE_NUMBER:   return data.number;
+    case NODE_VARIABLE: return (strcmp(data.word, "x") == 0) ? 2.0 : 3.0;
+    case NODE_FUNCTION: return calcFunction(data.op_code, Eval(node->right_));
+    }
+
+    if (node->left_ == nullptr) return -Eval(node->right_);
+
+    return calcOperator(data.op_code, Eval(node->left_), Eval(node->right_));
+}
+
+//------------------------------------------------------------------------------
+
+int main ()
+{
+    /* 7700 foldable spots, about 100k nodes */
+    std::string str = "x";
+    for (int k = 1; k <= 7700; ++k)
+        str += "+(2*3+" + std::to_string(k) + ")*y*1+sin(0.5)";
+
+    Tree<CalcNodeData> tree((char*)"fold");
+    Expression expr = { &str[0], &str[0] };
+    if (Expr2Tree(expr, tree)) return 1;
+
+    size_t   nodes_before = CountNodes(tree.root_);
+    NUM_TYPE value_before = Eval(tree.root_);
+
+    auto start = std::chrono::steady_clock::now();
+    Optimize(tree);
+    double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    NUM_TYPE value_after = Eval(tree.root_);
+
+    printf("fold:   %zu -> %zu nodes in %.4f s, value %s\n", nodes_before, CountNodes(tree.root_), time,
+           (value_before == value_after) ? "kept" : "CHANGED");
+
+    return (value_before == value_after) ? 0 : 1;
+}
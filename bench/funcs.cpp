@@ -0,0 +1,46 @@
+/*------------------------------------------------------------------------------
+    * File:        funcs.cpp                                                   *
+    * Description: Benchmark of the function name lookup.                      *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+#include "../Calculator/Calculator.h"
+#include <chrono>
+
+//------------------------------------------------------------------------------
+
+int main ()
+{
+    /* 20 function names and 4 misses */
+    const char* names[] =
+    {
+        "arccos", "arccosh", "arccot", "arccoth", "arcsin", "arcsinh", "arctan", "arctanh",
+        "cos", "cosh", "cot", "coth", "exp", "lg", "ln", "sin", "sinh", "sqrt", "tan", "tanh",
+        "foo", "x1", "abs", "log",
+    };
+    const size_t names_num = sizeof(names) / sizeof(names[0]);
+
+    char words[names_num][16] = {};
+    for (size_t i = 0; i < names_num; ++i) strcpy(words[i], names[i]);
+
+    size_t found = 0;
+    for (size_t i = 0; i < names_num; ++i) found += (findFunc(words[i]) != 0);
+
+    if (found != 20) return 1;
+
+    const int rounds = 1000000;
+    long      sum    = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r)
+        for (size_t i = 0; i < names_num; ++i) sum += findFunc(words[i]);
+    double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("funcs:  %zuM lookups in %.3f s (%ld)\n", rounds * names_num / 1000000, time, sum);
+
+    return 0;
+}
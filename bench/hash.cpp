@@ -0,0 +1,72 @@
+/*------------------------------------------------------------------------------
+    * File:        hash.cpp                                                    *
+    * Description: Benchmark of hash() and bit_rotate().                       *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+#include "../StackLib/hash.h"
+#include <chrono>
+#include <stdlib.h>
+#include <string.h>
+
+/* glibc allocator entries, so that the allocations in hash.cpp are counted */
+extern "C" void* __libc_malloc (size_t size);
+extern "C" void* __libc_calloc (size_t num, size_t size);
+
+static size_t allocs = 0;
+
+extern "C" void* malloc (size_t size)             { ++allocs; return __libc_malloc(size);      }
+extern "C" void* calloc (size_t num, size_t size) { ++allocs; return __libc_calloc(num, size); }
+
+//------------------------------------------------------------------------------
+
+int main ()
+{
+    const size_t sizes[] = { 40, 4096, 65536, 1 << 20 };
+    const size_t total   = 1 << 30;
+
+    unsigned char* buf = (unsigned char*)__libc_malloc(1 << 20);
+    for (size_t i = 0; i < (1 << 20); ++i) buf[i] = (unsigned char)(i * 131 + 7);
+
+    for (size_t size : sizes)
+    {
+        size_t calls = total / size;
+        hash_t sum   = 0;
+
+        size_t allocs_start = allocs;
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < calls; ++i) sum += hash(buf, size);
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        printf("hash:   %7zu B %6.2f GB/s, %.1f allocations per call (%016llx)\n",
+               size, total / time / 1e9, (double)(allocs - allocs_start) / calls, sum);
+    }
+
+    /* turning left must undo turning right */
+    unsigned char copy[256] = {};
+    memcpy(copy, buf, sizeof(copy));
+
+    size_t allocs_start = allocs;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int dir = 1; dir < 100000; ++dir)
+    {
+        bit_rotate(copy, sizeof(copy),  dir);
+        bit_rotate(copy, sizeof(copy), -dir);
+    }
+    double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    bool same = (memcmp(copy, buf, sizeof(copy)) == 0);
+
+    printf("hash:   200k bit_rotate of %zu B in %.3f s, %zu allocations, %s\n",
+           sizeof(copy), time, allocs - allocs_start, same ? "restored" : "NOT RESTORED");
+
+    free(buf);
+
+    return same ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+/*------------------------------------------------------------------------------
+    * File:        stack.cpp                                                   *
+    * Description: Benchmark of the Stack growth and cleaning.                 *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+#define NO_DUMP
+#define NO_HASH
+
+#include "../StackLib/Stack.h"
+#include <chrono>
+#include <string>
+
+/* trivially copyable value like the calculator's variables */
+struct Pod
+{
+    double      re;
+    double      im;
+    const char* name;
+};
+
+template<> const char* const PRINT_TYPE<Pod> = "Pod";
+template<> const Pod         POISON<Pod>     = { NAN, NAN, nullptr };
+
+bool isPOISON  (Pod value)           { return (value.name == nullptr) && isnan(value.re); }
+void TypePrint (FILE* fp, Pod value) { fprintf(fp, "%lf", value.re); }
+
+/* owns heap memory, so it must be moved and not copied bitwise */
+struct Owner
+{
+    std::string str;
+};
+
+template<> const char* const PRINT_TYPE<Owner> = "Owner";
+template<> const Owner       POISON<Owner>     = {};
+
+bool isPOISON  (const Owner& value)           { return value.str.empty(); }
+void TypePrint (FILE* fp, const Owner& value) { fprintf(fp, "%s", value.str.c_str()); }
+
+static size_t allocs = 0;
+
+void* operator new   (size_t size) { ++allocs; return malloc(size); }
+void* operator new[] (size_t size) { ++allocs; return malloc(size); }
+
+void operator delete   (void* ptr) noexcept { free(ptr); }
+void operator delete[] (void* ptr) noexcept { free(ptr); }
+void operator delete   (void* ptr, size_t) noexcept { free(ptr); }
+void operator delete[] (void* ptr, size_t) noexcept { free(ptr); }
+
+//------------------------------------------------------------------------------
+
+template <typename TYPE, typename MAKE>
+static void Run (const char* name, MAKE make)
+{
+    const int values_num = 60000;
+    const int runs       = 20;
+
+    double push_time = 0;
+
+    for (int r = 0; r < runs; ++r)
+    {
+        Stack<TYPE> stk((char*)"stk");
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < values_num; ++i) stk.Push(make(i));
+        for (int i = 0; i < values_num; ++i) stk.Pop();
+        push_time += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /* like the calculator loop: a few values, then Clean */
+    Stack<TYPE> stk((char*)"stk");
+    size_t allocs_start = allocs;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < 200000; ++r)
+    {
+        for (int i = 0; i < 10; ++i) stk.Push(make(i));
+        stk.Clean();
+    }
+    double clean_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    printf("stack:  %-6s %dk push+pop %6.2f ms, 200k rounds of 10 pushes + Clean %6.1f ms (%zu allocations)\n",
+           name, values_num / 1000, push_time / runs, clean_time, allocs - allocs_start);
+}
+
+//------------------------------------------------------------------------------
+
+int main ()
+{
+    Run<size_t>("size_t", [] (int i) { return (size_t)i; });
+    Run<Pod>   ("Pod",    [] (int i) { return Pod{ (double)i, 0, "x" }; });
+    Run<Owner> ("Owner",  [] (int i) { return Owner{ std::string(40, 'a' + i % 26) }; });
+
+    return 0;
+}
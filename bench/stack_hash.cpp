@@ -0,0 +1,45 @@
+/*------------------------------------------------------------------------------
+    * File:        stack_hash.cpp                                              *
+    * Description: Benchmark of the Stack pushes with the hash protection.     *
+    * Created:     16 oct 2026                                                 *
+    * Author:      Artem Puzankov                                              *
+    * Email:       puzankov.ao@phystech.edu                                    *
+    * GitHub:      https://github.com/hellopuza                                *
+    * Copyright © 2021 Artem Puzankov. All rights reserved.                    *
+    *///------------------------------------------------------------------------
+
+#define NO_DUMP
+
+#include "../StackLib/Stack.h"
+#include <chrono>
+
+//------------------------------------------------------------------------------
+
+int main ()
+{
+    const size_t pushes[] = { 2000, 20000, 200000, 1000000 };
+
+    for (size_t pushes_num : pushes)
+    {
+        size_t round = (pushes_num < 50000) ? pushes_num : 50000;
+
+        Stack<size_t> stk((char*)"stk");
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t done = 0; done < pushes_num; done += round)
+        {
+            for (size_t i = 0; i < round; ++i) stk.Push(i);
+
+            /* the full rehash must agree with the incremental one */
+            if (stk.Verify()) return 1;
+
+            stk.Clean();
+        }
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        printf("stack_hash: %7zu pushes (rounds of %zu) %7.3f s, %6.1f ns/push\n",
+               pushes_num, round, time, time / pushes_num * 1e9);
+    }
+
+    return 0;
+}
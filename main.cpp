@@ -14,15 +14,57 @@
 
 int main(int argc, char* argv[])
 {
-    if (argc == 1)
+    int   eval_mode   = EVAL_BYTECODE;
+    int   threads_num = 0;
+    bool  real_mode   = true;
+    bool  stats       = false;
+    char* filename    = nullptr;
+    char* batch       = nullptr;
+    char* save        = nullptr;
+    bool  load        = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if      (strcmp(argv[i], "--tree")     == 0) eval_mode = EVAL_TREE;
+        else if (strcmp(argv[i], "--flat")     == 0) eval_mode = EVAL_FLAT;
+        else if (strcmp(argv[i], "--bytecode") == 0) eval_mode = EVAL_BYTECODE;
+        else if (strcmp(argv[i], "--jit")      == 0) eval_mode = EVAL_JIT;
+        else if (strcmp(argv[i], "--aot")      == 0) eval_mode = EVAL_AOT;
+        else if (strcmp(argv[i], "--complex")  == 0) real_mode = false;
+        else if (strcmp(argv[i], "--stats")    == 0) stats     = true;
+        else if (strcmp(argv[i], "--load")     == 0) load      = true;
+        else if ((strcmp(argv[i], "--threads") == 0) && (i + 1 < argc)) threads_num = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--batch")   == 0) && (i + 1 < argc)) batch       = argv[++i];
+        else if ((strcmp(argv[i], "--save")    == 0) && (i + 1 < argc)) save        = argv[++i];
+        else filename = argv[i];
+    }
+
+    if (threads_num < 0)
+    {
+        printf("Usage: --threads N, where N >= 0 (0 means all cores)\n");
+        return CALC_NOT_OK;
+    }
+
+    if (filename == nullptr)
     {
         Calculator calc;
+        calc.setEvalMode(eval_mode);
+        calc.setThreadsNum(threads_num);
+        calc.setRealMode(real_mode);
+        calc.setStats(stats);
 
         return calc.Run();
     }
     else
     {
-        Calculator calc(argv[1]);
+        Calculator calc(filename);
+        calc.setEvalMode(eval_mode);
+        calc.setThreadsNum(threads_num);
+        calc.setRealMode(real_mode);
+        calc.setStats(stats);
+        calc.setBatchOutput(batch);
+        calc.setSaveFile(save);
+        calc.setLoadFile(load);
 
         return calc.Run();
     }